@@ -0,0 +1,158 @@
+/**
+ * \file StructArgs.cpp
+ * \brief Definition of member functions in StructArgs.
+ * \date 2026-10-18
+ */
+
+
+// class header
+# include "StructArgs.hpp"
+
+
+namespace
+{
+
+/** \brief Read a comma-separated list of integers if the option is given. */
+PetscErrorCode getInts(const char *name, std::vector<PetscInt> &values)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            buffer[64],
+                        n = 64;
+
+    PetscBool           set;
+
+    ierr = PetscOptionsGetIntArray(
+            nullptr, nullptr, name, buffer, &n, &set); CHKERRQ(ierr);
+
+    if (set) values.assign(buffer, buffer + n);
+
+    PetscFunctionReturn(0);
+}
+
+
+/** \brief Read a comma-separated list of strings if the option is given. */
+PetscErrorCode getStrings(const char *name,
+        const std::vector<std::string> &allowed,
+        std::vector<std::string> &values)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    char                *buffer[16];
+
+    PetscInt            n = 16;
+
+    PetscBool           set;
+
+    ierr = PetscOptionsGetStringArray(
+            nullptr, nullptr, name, buffer, &n, &set); CHKERRQ(ierr);
+
+    if (! set) PetscFunctionReturn(0);
+
+    values.clear();
+    for (PetscInt i = 0; i < n; ++i)
+    {
+        values.emplace_back(buffer[i]);
+        ierr = PetscFree(buffer[i]); CHKERRQ(ierr);
+    }
+
+    for (const std::string &v: values)
+    {
+        bool    found = false;
+
+        for (const std::string &a: allowed) found = found || (v == a);
+
+        if (! found) SETERRQ2(PETSC_COMM_WORLD, PETSC_ERR_ARG_WRONG,
+                "Invalid value %s for option %s.\n", v.c_str(), name);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+} // end of anonymous namespace
+
+
+// definition of getArgs
+PetscErrorCode StructArgs::getArgs()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    char                buffer[PETSC_MAX_PATH_LEN];
+
+    PetscBool           set;
+
+    ierr = PetscOptionsGetString(nullptr, nullptr, "-config",
+            buffer, sizeof(buffer), &set); CHKERRQ(ierr);
+    if (! set) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_NULL,
+            "-config is required.\n");
+    cfgFile = buffer;
+
+    ierr = PetscOptionsGetString(nullptr, nullptr, "-mode",
+            buffer, sizeof(buffer), &set); CHKERRQ(ierr);
+    if (set) mode = buffer;
+
+    ierr = PetscOptionsGetString(nullptr, nullptr, "-output",
+            buffer, sizeof(buffer), &set); CHKERRQ(ierr);
+    if (set) output = buffer;
+
+    ierr = getInts("-sizes", sizes); CHKERRQ(ierr);
+    ierr = getInts("-stencils", stencils); CHKERRQ(ierr);
+    ierr = getInts("-ranks_per_device", ranksPerDevice); CHKERRQ(ierr);
+
+    ierr = getStrings("-inputs", {"mat", "host", "device"}, inputs);
+    CHKERRQ(ierr);
+    ierr = getStrings("-partitions", {"offsets", "vector"}, partitions);
+    CHKERRQ(ierr);
+
+    ierr = PetscOptionsGetInt(nullptr, nullptr, "-reps", &reps, nullptr);
+    CHKERRQ(ierr);
+    ierr = PetscOptionsGetInt(nullptr, nullptr, "-warmup", &warmup, nullptr);
+    CHKERRQ(ierr);
+
+    if (reps < 1) SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE,
+            "-reps must be positive, got %D.\n", reps);
+
+    for (PetscInt rpd: ranksPerDevice)
+        if (rpd < 1) SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE,
+                "-ranks_per_device must be positive, got %D.\n", rpd);
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of checkHelp
+PetscErrorCode StructArgs::checkHelp(PetscBool &help)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    help = PETSC_FALSE;
+    ierr = PetscOptionsGetBool(nullptr, nullptr, "-print", &help, nullptr);
+    CHKERRQ(ierr);
+
+    if (! help) PetscFunctionReturn(0);
+
+    ierr = PetscPrintf(PETSC_COMM_WORLD,
+            "Necessary Parameters:\n"
+            "\t-config [AmgX configuration file]\n"
+            "Optional Parameters:\n"
+            "\t-mode [dDDI, dDFI, dFFI, hDDI, hDFI, or hFFI; default dDDI]\n"
+            "\t-sizes [grid points per direction, e.g., 16,32,64]\n"
+            "\t-stencils [7 and/or 27]\n"
+            "\t-ranks_per_device [processes sharing a device, e.g., 1,2,4]\n"
+            "\t-inputs [mat, host, and/or device]\n"
+            "\t-partitions [offsets and/or vector]\n"
+            "\t-reps [timed repetitions per case; default 10]\n"
+            "\t-warmup [untimed repetitions per case; default 1]\n"
+            "\t-output [file for the records; default stdout]\n");
+    CHKERRQ(ierr);
+
+    PetscFunctionReturn(0);
+}
@@ -0,0 +1,66 @@
+/**
+ * \file StructArgs.hpp
+ * \brief Definition of StructArgs, the options of the benchmark.
+ * \date 2026-10-18
+ */
+
+
+# pragma once
+
+// STL
+# include <string>
+# include <vector>
+
+// PETSc
+# include <petscsys.h>
+
+
+/** \brief A structure holding the parameter sweep of a benchmark run. */
+struct StructArgs
+{
+    /** \brief AmgX mode, e.g., dDDI or hDDI. */
+    std::string                 mode = "dDDI";
+
+    /** \brief Path to the AmgX configuration file. */
+    std::string                 cfgFile;
+
+    /** \brief Where to write the records; empty means stdout. */
+    std::string                 output;
+
+    /** \brief Grid points per direction of the 3D problems. */
+    std::vector<PetscInt>       sizes = {32};
+
+    /** \brief Stencils of the problems, 7 and/or 27. */
+    std::vector<PetscInt>       stencils = {7, 27};
+
+    /** \brief MPI processes sharing one device. */
+    std::vector<PetscInt>       ranksPerDevice = {1};
+
+    /** \brief How the matrix is handed over: mat, host, and/or device. */
+    std::vector<std::string>    inputs = {"mat", "host", "device"};
+
+    /** \brief How the partitioning is described: offsets and/or vector. */
+    std::vector<std::string>    partitions = {"offsets", "vector"};
+
+    /** \brief Number of timed repetitions per case. */
+    PetscInt                    reps = 10;
+
+    /** \brief Number of untimed repetitions before the timed ones. */
+    PetscInt                    warmup = 1;
+
+
+    /** \brief Read the options from the PETSc options database.
+     *
+     * \return PetscErrorCode.
+     */
+    PetscErrorCode getArgs();
+
+
+    /** \brief Print the usage if -print is given.
+     *
+     * \param help [out] whether -print was given.
+     *
+     * \return PetscErrorCode.
+     */
+    PetscErrorCode checkHelp(PetscBool &help);
+};
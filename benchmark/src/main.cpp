@@ -0,0 +1,370 @@
+/**
+ * \file main.cpp
+ * \brief A micro-benchmark of the phases of AmgXSolver::setA and solve.
+ *
+ * For every combination of problem size, stencil, processes per device, way
+ * of handing over the matrix (a PETSc Mat, or raw CSR arrays on the host or on
+ * the device), and partitioning (offsets or a partition vector), this program
+ * repeatedly initializes an AmgXSolver, sets the matrix, solves once, and
+ * finalizes the solver. Each phase is timed through the PETSc events
+ * AmgXSolver logs, so the numbers are the ones -log_view would show.
+ *
+ * The output is one JSON record per line for each case and phase, holding the
+ * median, quartiles, and extrema of the phase time over the repetitions. The
+ * time of a repetition is the maximum over the processes.
+ *
+ * The problems are 3D Laplacians with 7- or 27-point stencils and Dirichlet
+ * boundaries. The solve is only there to time the vector transfers, so a cheap
+ * configuration, e.g., configs/AmgX_Bench.info, is enough.
+ *
+ * \date 2026-10-18
+ */
+
+
+// STL
+# include <algorithm>
+# include <cstdio>
+# include <string>
+# include <vector>
+
+// CUDA
+# include <cuda_runtime.h>
+
+// PETSc
+# include <petscsys.h>
+# include <petscmat.h>
+# include <petscvec.h>
+
+// AmgXWrapper
+# include <AmgXSolver.hpp>
+
+// headers
+# include "StructArgs.hpp"
+# include "problem.hpp"
+# include "timer.hpp"
+
+
+/**
+ * \brief Time the repetitions of one case.
+ *
+ * \param comm [in] the processes taking part in this case.
+ * \param args [in] the options of this run.
+ * \param input [in] mat, host, or device.
+ * \param partition [in] offsets or vector.
+ * \param A [in] the matrix, for the mat input.
+ * \param csr [in] the local rows, for the host input.
+ * \param dev [in] the local rows, for the device input.
+ * \param samples [out] the timings on this process.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode runCase(const MPI_Comm &comm, const StructArgs &args,
+        const std::string &input, const std::string &partition,
+        const Mat &A, const CSR &csr, const DeviceCSR &dev, Samples &samples)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscMPIInt         size;
+
+    Vec                 lhs,
+                        rhs;
+
+    std::vector<PetscScalar>    hLhs(csr.nLocal, 0.0),
+                                hRhs(csr.nLocal, 1.0);
+
+    std::vector<PetscInt>       partData;
+
+    ierr = MPI_Comm_size(comm, &size); CHKERRQ(ierr);
+
+    ierr = MatCreateVecs(A, &lhs, &rhs); CHKERRQ(ierr);
+    ierr = VecSet(rhs, 1.0); CHKERRQ(ierr);
+
+    // AmgXSolver::getPartData reads this at every setA
+    ierr = PetscOptionsSetValue(nullptr, "-amgx_partition_vector",
+            (partition == "vector") ? "1" : "0"); CHKERRQ(ierr);
+
+    // the raw setA takes the owning rank of every row instead of offsets
+    if (input != "mat" && partition == "vector")
+    {
+        std::vector<PetscMPIInt>    counts(size);
+        PetscMPIInt                 n = csr.nLocal;
+
+        ierr = MPI_Allgather(&n, 1, MPI_INT,
+                counts.data(), 1, MPI_INT, comm); CHKERRQ(ierr);
+
+        for (PetscMPIInt r = 0; r < size; ++r)
+            partData.insert(partData.end(), counts[r], r);
+    }
+
+    samples.clear();
+
+    for (PetscInt rep = -args.warmup; rep < args.reps; ++rep)
+    {
+        AmgXSolver      solver;
+
+        Snapshot        before,
+                        after;
+
+        double          tInit, tSetA, tSolve, tFinal;
+
+        // the initial guess is reset outside of the timed region
+        ierr = VecSet(lhs, 0.0); CHKERRQ(ierr);
+        std::fill(hLhs.begin(), hLhs.end(), 0.0);
+        if (input == "device") CHECK(cudaMemcpy(dev.lhs, hLhs.data(),
+                    csr.nLocal * sizeof(PetscScalar), cudaMemcpyHostToDevice));
+
+        ierr = MPI_Barrier(comm); CHKERRQ(ierr);
+        tInit = MPI_Wtime();
+        ierr = solver.initialize(comm, args.mode, args.cfgFile); CHKERRQ(ierr);
+        tInit = MPI_Wtime() - tInit;
+
+        ierr = takeSnapshot(before); CHKERRQ(ierr);
+
+        ierr = MPI_Barrier(comm); CHKERRQ(ierr);
+        tSetA = MPI_Wtime();
+        if (input == "mat")
+        {
+            ierr = solver.setA(A); CHKERRQ(ierr);
+        }
+        else
+        {
+            const bool  onDev = (input == "device");
+
+            ierr = solver.setA(csr.nGlobal, csr.nLocal, csr.col.size(),
+                    onDev ? dev.row : csr.row.data(),
+                    onDev ? dev.col : csr.col.data(),
+                    onDev ? dev.val : csr.val.data(),
+                    partData.empty() ? nullptr : partData.data());
+            CHKERRQ(ierr);
+        }
+        tSetA = MPI_Wtime() - tSetA;
+
+        ierr = MPI_Barrier(comm); CHKERRQ(ierr);
+        tSolve = MPI_Wtime();
+        if (input == "mat")
+        {
+            ierr = solver.solve(lhs, rhs); CHKERRQ(ierr);
+        }
+        else if (input == "host")
+        {
+            ierr = solver.solve(hLhs.data(), hRhs.data(), csr.nLocal);
+            CHKERRQ(ierr);
+        }
+        else
+        {
+            ierr = solver.solve(dev.lhs, dev.rhs, csr.nLocal); CHKERRQ(ierr);
+        }
+        tSolve = MPI_Wtime() - tSolve;
+
+        ierr = takeSnapshot(after); CHKERRQ(ierr);
+
+        ierr = MPI_Barrier(comm); CHKERRQ(ierr);
+        tFinal = MPI_Wtime();
+        ierr = solver.finalize(); CHKERRQ(ierr);
+        tFinal = MPI_Wtime() - tFinal;
+
+        if (rep < 0) continue;
+
+        samples["initialize"].push_back(tInit);
+        samples["setA"].push_back(tSetA);
+        samples["solve"].push_back(tSolve);
+        samples["finalize"].push_back(tFinal);
+        ierr = addDeltas(before, after, samples); CHKERRQ(ierr);
+    }
+
+    ierr = PetscOptionsClearValue(nullptr, "-amgx_partition_vector");
+    CHKERRQ(ierr);
+
+    ierr = VecDestroy(&lhs); CHKERRQ(ierr);
+    ierr = VecDestroy(&rhs); CHKERRQ(ierr);
+
+    PetscFunctionReturn(0);
+}
+
+
+/**
+ * \brief Run all cases of a processes-per-device setting.
+ *
+ * \param comm [in] the processes taking part.
+ * \param args [in] the options of this run.
+ * \param rpd [in] processes per device.
+ * \param fp [in] the file to write the records to.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode runSweep(const MPI_Comm &comm, const StructArgs &args,
+        const PetscInt rpd, FILE *fp)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscMPIInt         size;
+
+    CaseInfo            info;
+
+    ierr = MPI_Comm_size(comm, &size); CHKERRQ(ierr);
+
+    info.mode = args.mode;
+    info.ranks = size;
+    info.ranksPerDevice = rpd;
+
+    for (PetscInt N: args.sizes)
+    {
+        for (PetscInt stencil: args.stencils)
+        {
+            Mat         A;
+            CSR         csr;
+            DeviceCSR   dev;
+
+            ierr = createMatrix(comm, N, stencil, A); CHKERRQ(ierr);
+            ierr = getCSR(A, csr); CHKERRQ(ierr);
+
+            info.size = N;
+            info.rows = csr.nGlobal;
+            info.stencil = stencil;
+
+            for (const std::string &input: args.inputs)
+            {
+                // AmgX in host modes cannot read device memory
+                if (input == "device" && args.mode[0] == 'h') continue;
+
+                if (input == "device")
+                {
+                    std::vector<PetscScalar>    lhs(csr.nLocal, 0.0),
+                                                rhs(csr.nLocal, 1.0);
+
+                    ierr = toDevice(csr, lhs, rhs, dev); CHKERRQ(ierr);
+                }
+
+                for (const std::string &partition: args.partitions)
+                {
+                    Samples     samples;
+
+                    ierr = runCase(comm, args, input, partition,
+                            A, csr, dev, samples); CHKERRQ(ierr);
+                    ierr = reduceMax(comm, samples); CHKERRQ(ierr);
+
+                    info.input = input;
+                    info.partition = partition;
+                    ierr = writeRecords(fp, info, samples); CHKERRQ(ierr);
+                }
+
+                if (input == "device")
+                {
+                    ierr = freeDevice(dev); CHKERRQ(ierr);
+                }
+            }
+
+            ierr = MatDestroy(&A); CHKERRQ(ierr);
+        }
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+int main(int argc, char **argv)
+{
+    PetscErrorCode      ierr;
+
+    StructArgs          args;
+
+    PetscBool           help;
+
+    MPI_Comm            nodeComm;
+
+    PetscMPIInt         nodeRank,
+                        nodeSize;
+
+    int                 nDevs;
+
+    FILE                *fp = PETSC_STDOUT;
+
+
+    ierr = PetscInitialize(&argc, &argv, nullptr, nullptr); CHKERRQ(ierr);
+    ierr = PetscLogDefaultBegin(); CHKERRQ(ierr);
+
+    ierr = args.checkHelp(help); CHKERRQ(ierr);
+    if (help) { ierr = PetscFinalize(); return ierr; }
+
+    ierr = args.getArgs(); CHKERRQ(ierr);
+
+    if (! args.output.empty())
+    {
+        ierr = PetscFOpen(PETSC_COMM_WORLD,
+                args.output.c_str(), "w", &fp); CHKERRQ(ierr);
+    }
+
+    // processes are handed to devices node by node, like AmgXSolver does
+    ierr = MPI_Comm_split_type(PETSC_COMM_WORLD,
+            MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeComm); CHKERRQ(ierr);
+    ierr = MPI_Comm_rank(nodeComm, &nodeRank); CHKERRQ(ierr);
+    ierr = MPI_Comm_size(nodeComm, &nodeSize); CHKERRQ(ierr);
+
+    // in host modes, AmgXSolver treats every process as a device of its own
+    if (args.mode[0] == 'h')
+    {
+        nDevs = nodeSize;
+        if (args.ranksPerDevice != std::vector<PetscInt>{1})
+        {
+            ierr = PetscFPrintf(PETSC_COMM_WORLD, PETSC_STDERR,
+                    "Host modes always use one process per device; "
+                    "-ranks_per_device is ignored.\n"); CHKERRQ(ierr);
+            args.ranksPerDevice = {1};
+        }
+    }
+    else
+    {
+        CHECK(cudaGetDeviceCount(&nDevs));
+    }
+
+    for (PetscInt rpd: args.ranksPerDevice)
+    {
+        PetscMPIInt     need = nDevs * rpd,
+                        fewest;
+
+        MPI_Comm        comm;
+
+        // every node has to fill all of its devices
+        ierr = MPI_Allreduce(&nodeSize, &fewest, 1, MPI_INT, MPI_MIN,
+                PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+        if (fewest < need)
+        {
+            ierr = PetscFPrintf(PETSC_COMM_WORLD, PETSC_STDERR,
+                    "Skipping %D processes per device: %d processes per "
+                    "node are needed, but a node only has %d.\n",
+                    rpd, need, fewest); CHKERRQ(ierr);
+            continue;
+        }
+
+        ierr = MPI_Comm_split(PETSC_COMM_WORLD,
+                (nodeRank < need) ? 0 : MPI_UNDEFINED, 0, &comm);
+        CHKERRQ(ierr);
+
+        if (comm != MPI_COMM_NULL)
+        {
+            // device arrays must live on the device AmgXSolver picks
+            if (args.mode[0] == 'd') CHECK(cudaSetDevice(nodeRank / rpd));
+
+            ierr = runSweep(comm, args, rpd, fp); CHKERRQ(ierr);
+            ierr = MPI_Comm_free(&comm); CHKERRQ(ierr);
+        }
+
+        ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+    }
+
+    ierr = MPI_Comm_free(&nodeComm); CHKERRQ(ierr);
+
+    if (! args.output.empty())
+    {
+        ierr = PetscFClose(PETSC_COMM_WORLD, fp); CHKERRQ(ierr);
+    }
+
+    ierr = PetscFinalize(); CHKERRQ(ierr);
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * \file problem.cpp
+ * \brief Definitions of functions generating the benchmark problems.
+ * \date 2026-10-18
+ */
+
+
+// CUDA
+# include <cuda_runtime.h>
+
+// AmgXWrapper, for the CHECK macro
+# include <AmgXSolver.hpp>
+
+// headers
+# include "problem.hpp"
+
+
+// definition of createMatrix
+PetscErrorCode createMatrix(const MPI_Comm &comm,
+        const PetscInt &N, const PetscInt &stencil, Mat &A)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            bg, ed;
+
+    // 7-point stencils only use the faces, 27-point ones the whole cube
+    const PetscInt      reach = (stencil == 7) ? 1 : 3;
+
+    if (stencil != 7 && stencil != 27) SETERRQ1(comm, PETSC_ERR_ARG_OUTOFRANGE,
+            "Stencil must be 7 or 27, got %D.\n", stencil);
+
+    ierr = MatCreate(comm, &A); CHKERRQ(ierr);
+    ierr = MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, N*N*N, N*N*N); CHKERRQ(ierr);
+    ierr = MatSetType(A, MATAIJ); CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(A, stencil, nullptr); CHKERRQ(ierr);
+    ierr = MatMPIAIJSetPreallocation(A, stencil, nullptr, stencil, nullptr);
+    CHKERRQ(ierr);
+
+    ierr = MatGetOwnershipRange(A, &bg, &ed); CHKERRQ(ierr);
+
+    for (PetscInt r = bg; r < ed; ++r)
+    {
+        PetscInt        i = r % N,
+                        j = (r / N) % N,
+                        k = r / (N * N);
+
+        PetscInt        cols[27];
+        PetscScalar     vals[27];
+        PetscInt        n = 0;
+
+        for (PetscInt dk = -1; dk <= 1; ++dk)
+            for (PetscInt dj = -1; dj <= 1; ++dj)
+                for (PetscInt di = -1; di <= 1; ++di)
+                {
+                    PetscInt    dist = (di != 0) + (dj != 0) + (dk != 0);
+
+                    if (dist == 0 || dist > reach) continue;
+                    if (i+di < 0 || i+di >= N || j+dj < 0 || j+dj >= N ||
+                            k+dk < 0 || k+dk >= N) continue;
+
+                    cols[n] = r + di + dj * N + dk * N * N;
+                    vals[n] = -1.0;
+                    n += 1;
+                }
+
+        // neighbours outside the domain act as Dirichlet boundaries, which
+        // keeps the matrix strictly diagonally dominant on the boundary
+        cols[n] = r;
+        vals[n] = stencil - 1;
+        n += 1;
+
+        ierr = MatSetValues(A, 1, &r, n, cols, vals, INSERT_VALUES);
+        CHKERRQ(ierr);
+    }
+
+    ierr = MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of getCSR
+PetscErrorCode getCSR(const Mat &A, CSR &csr)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            bg, ed;
+
+    ierr = MatGetSize(A, &csr.nGlobal, nullptr); CHKERRQ(ierr);
+    ierr = MatGetOwnershipRange(A, &bg, &ed); CHKERRQ(ierr);
+
+    csr.nLocal = ed - bg;
+    csr.row.assign(1, 0);
+    csr.col.clear();
+    csr.val.clear();
+
+    for (PetscInt r = bg; r < ed; ++r)
+    {
+        PetscInt            n;
+        const PetscInt      *cols;
+        const PetscScalar   *vals;
+
+        ierr = MatGetRow(A, r, &n, &cols, &vals); CHKERRQ(ierr);
+        csr.col.insert(csr.col.end(), cols, cols + n);
+        csr.val.insert(csr.val.end(), vals, vals + n);
+        csr.row.push_back(csr.col.size());
+        ierr = MatRestoreRow(A, r, &n, &cols, &vals); CHKERRQ(ierr);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of toDevice
+PetscErrorCode toDevice(const CSR &csr, const std::vector<PetscScalar> &lhs,
+        const std::vector<PetscScalar> &rhs, DeviceCSR &dev)
+{
+    PetscFunctionBeginUser;
+
+    const size_t    nRow = csr.row.size() * sizeof(PetscInt),
+                    nCol = csr.col.size() * sizeof(PetscInt),
+                    nVal = csr.val.size() * sizeof(PetscScalar),
+                    nVec = csr.nLocal * sizeof(PetscScalar);
+
+    CHECK(cudaMalloc((void**)&dev.row, nRow));
+    CHECK(cudaMalloc((void**)&dev.col, nCol));
+    CHECK(cudaMalloc((void**)&dev.val, nVal));
+    CHECK(cudaMalloc((void**)&dev.lhs, nVec));
+    CHECK(cudaMalloc((void**)&dev.rhs, nVec));
+
+    CHECK(cudaMemcpy(dev.row, csr.row.data(), nRow, cudaMemcpyHostToDevice));
+    CHECK(cudaMemcpy(dev.col, csr.col.data(), nCol, cudaMemcpyHostToDevice));
+    CHECK(cudaMemcpy(dev.val, csr.val.data(), nVal, cudaMemcpyHostToDevice));
+    CHECK(cudaMemcpy(dev.lhs, lhs.data(), nVec, cudaMemcpyHostToDevice));
+    CHECK(cudaMemcpy(dev.rhs, rhs.data(), nVec, cudaMemcpyHostToDevice));
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of freeDevice
+PetscErrorCode freeDevice(DeviceCSR &dev)
+{
+    PetscFunctionBeginUser;
+
+    CHECK(cudaFree(dev.row));
+    CHECK(cudaFree(dev.col));
+    CHECK(cudaFree(dev.val));
+    CHECK(cudaFree(dev.lhs));
+    CHECK(cudaFree(dev.rhs));
+
+    dev = DeviceCSR();
+
+    PetscFunctionReturn(0);
+}
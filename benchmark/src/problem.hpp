@@ -0,0 +1,89 @@
+/**
+ * \file problem.hpp
+ * \brief Prototypes of functions generating the benchmark problems.
+ * \date 2026-10-18
+ */
+
+
+# pragma once
+
+// STL
+# include <vector>
+
+// PETSc
+# include <petscmat.h>
+# include <petscvec.h>
+
+
+/** \brief Local rows of a matrix in CSR format with global column indices. */
+struct CSR
+{
+    PetscInt                    nGlobal,
+                                nLocal;
+
+    std::vector<PetscInt>       row,
+                                col;
+
+    std::vector<PetscScalar>    val;
+};
+
+
+/** \brief Copies of a CSR matrix and two vectors in device memory. */
+struct DeviceCSR
+{
+    PetscInt                    *row = nullptr,
+                                *col = nullptr;
+
+    PetscScalar                 *val = nullptr,
+                                *lhs = nullptr,
+                                *rhs = nullptr;
+};
+
+
+/**
+ * \brief Assemble an SPD matrix of a 3D Laplacian on an N^3 grid.
+ *
+ * \param comm [in] the communicator the matrix lives on.
+ * \param N [in] number of grid points in each direction.
+ * \param stencil [in] 7 or 27 (neighbours plus the center point).
+ * \param A [out] the MATAIJ matrix.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode createMatrix(const MPI_Comm &comm,
+        const PetscInt &N, const PetscInt &stencil, Mat &A);
+
+
+/**
+ * \brief Copy the local rows of a matrix out as CSR.
+ *
+ * \param A [in] a MATAIJ matrix.
+ * \param csr [out] the local rows.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode getCSR(const Mat &A, CSR &csr);
+
+
+/**
+ * \brief Allocate device memory for and copy a CSR matrix and two vectors.
+ *
+ * \param csr [in] the local rows.
+ * \param lhs [in] the initial guess.
+ * \param rhs [in] the right-hand side.
+ * \param dev [out] device copies.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode toDevice(const CSR &csr, const std::vector<PetscScalar> &lhs,
+        const std::vector<PetscScalar> &rhs, DeviceCSR &dev);
+
+
+/**
+ * \brief Free the device copies.
+ *
+ * \param dev [in, out] device copies.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode freeDevice(DeviceCSR &dev);
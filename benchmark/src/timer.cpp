@@ -0,0 +1,126 @@
+/**
+ * \file timer.cpp
+ * \brief Definitions of functions collecting and summarizing timings.
+ * \date 2026-10-18
+ */
+
+
+// STL
+# include <algorithm>
+
+// headers
+# include "timer.hpp"
+
+
+// the names are fixed in AmgXSolver::eventNames
+const std::vector<std::string> eventNames = {
+    "AmgXGetDevIS", "AmgXRedistMat", "AmgXGetRawData", "AmgXGetPartData",
+    "AmgXConsolidate", "AmgXUploadA", "AmgXSetup", "AmgXResetup",
+    "AmgXVecScatter", "AmgXVecUpload", "AmgXSolve", "AmgXVecDownload",
+    "AmgXMPIWait"};
+
+
+namespace
+{
+
+/** \brief Linearly interpolated quantile of sorted data. */
+double quantile(const std::vector<double> &sorted, const double q)
+{
+    double      pos = q * (sorted.size() - 1);
+    size_t      lo = static_cast<size_t>(pos);
+    size_t      hi = std::min(lo + 1, sorted.size() - 1);
+
+    return sorted[lo] + (pos - lo) * (sorted[hi] - sorted[lo]);
+}
+
+} // end of anonymous namespace
+
+
+// definition of takeSnapshot
+PetscErrorCode takeSnapshot(Snapshot &snap)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    snap.assign(eventNames.size(), 0.0);
+
+    for (size_t i = 0; i < eventNames.size(); ++i)
+    {
+        PetscLogEvent       event;
+        PetscEventPerfInfo  info;
+
+        ierr = PetscLogEventGetId(eventNames[i].c_str(), &event);
+        CHKERRQ(ierr);
+
+        ierr = PetscLogEventGetPerfInfo(PETSC_DETERMINE, event, &info);
+        CHKERRQ(ierr);
+
+        snap[i] = info.time;
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of addDeltas
+PetscErrorCode addDeltas(const Snapshot &before, const Snapshot &after,
+        Samples &samples)
+{
+    PetscFunctionBeginUser;
+
+    for (size_t i = 0; i < eventNames.size(); ++i)
+        samples[eventNames[i]].push_back(after[i] - before[i]);
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of reduceMax
+PetscErrorCode reduceMax(const MPI_Comm &comm, Samples &samples)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    for (auto &it: samples)
+    {
+        ierr = MPI_Allreduce(MPI_IN_PLACE, it.second.data(),
+                it.second.size(), MPI_DOUBLE, MPI_MAX, comm); CHKERRQ(ierr);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of writeRecords
+PetscErrorCode writeRecords(FILE *fp, const CaseInfo &info,
+        const Samples &samples)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    for (const auto &it: samples)
+    {
+        std::vector<double>     s(it.second);
+
+        std::sort(s.begin(), s.end());
+
+        if (s.back() == 0.0) continue;
+
+        ierr = PetscFPrintf(PETSC_COMM_WORLD, fp,
+                "{\"mode\": \"%s\", \"size\": %D, \"rows\": %D, "
+                "\"stencil\": %D, \"ranks\": %D, \"ranks_per_device\": %D, "
+                "\"input\": \"%s\", \"partition\": \"%s\", \"phase\": \"%s\", "
+                "\"reps\": %d, \"median\": %.6e, \"q1\": %.6e, \"q3\": %.6e, "
+                "\"min\": %.6e, \"max\": %.6e}\n",
+                info.mode.c_str(), info.size, info.rows, info.stencil,
+                info.ranks, info.ranksPerDevice, info.input.c_str(),
+                info.partition.c_str(), it.first.c_str(), int(s.size()),
+                quantile(s, 0.5), quantile(s, 0.25), quantile(s, 0.75),
+                s.front(), s.back()); CHKERRQ(ierr);
+    }
+
+    PetscFunctionReturn(0);
+}
@@ -0,0 +1,97 @@
+/**
+ * \file timer.hpp
+ * \brief Collecting and summarizing timings of the wrapper phases.
+ * \date 2026-10-18
+ */
+
+
+# pragma once
+
+// STL
+# include <cstdio>
+# include <map>
+# include <string>
+# include <vector>
+
+// PETSc
+# include <petscsys.h>
+
+
+/** \brief Names of the PETSc events AmgXSolver logs its phases with. */
+extern const std::vector<std::string> eventNames;
+
+
+/** \brief Accumulated times of all events in eventNames, in seconds. */
+using Snapshot = std::vector<PetscLogDouble>;
+
+
+/** \brief Timings of one case; phase name -> one sample per repetition. */
+using Samples = std::map<std::string, std::vector<double>>;
+
+
+/** \brief Parameters identifying a case in the records. */
+struct CaseInfo
+{
+    std::string     mode,
+                    input,
+                    partition;
+
+    PetscInt        size,
+                    rows,
+                    stencil,
+                    ranks,
+                    ranksPerDevice;
+};
+
+
+/**
+ * \brief Read the accumulated times of the events in eventNames.
+ *
+ * AmgXSolver registers the events in its first initialize.
+ *
+ * \param snap [out] the times.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode takeSnapshot(Snapshot &snap);
+
+
+/**
+ * \brief Append the time spent in each event between two snapshots.
+ *
+ * \param before [in] the earlier snapshot.
+ * \param after [in] the later snapshot.
+ * \param samples [in, out] the samples of the case.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode addDeltas(const Snapshot &before, const Snapshot &after,
+        Samples &samples);
+
+
+/**
+ * \brief Reduce samples to their maxima over the processes of a communicator.
+ *
+ * A phase is only as fast as its slowest process.
+ *
+ * \param comm [in] the communicator running the case.
+ * \param samples [in, out] the samples of the case.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode reduceMax(const MPI_Comm &comm, Samples &samples);
+
+
+/**
+ * \brief Write one JSON record per phase with the statistics of its samples.
+ *
+ * Phases that never took any time are skipped.
+ *
+ * \param fp [in] the file to write to; only used on rank 0 of PETSC_COMM_WORLD.
+ * \param info [in] the parameters of the case.
+ * \param samples [in] the samples of the case.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode writeRecords(FILE *fp, const CaseInfo &info,
+        const Samples &samples);
@@ -29,6 +29,8 @@ PetscErrorCode StructArgs::print()
     ierr = PetscPrintf(PETSC_COMM_WORLD, "Mode: %s\n", mode); CHKERRQ(ierr);
     ierr = PetscPrintf(PETSC_COMM_WORLD, "Config File: %s\n", cfgFileName); CHKERRQ(ierr);
     ierr = PetscPrintf(PETSC_COMM_WORLD, "Number of Solves: %d\n", Nruns); CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "Use Null Space ? %s\n",
+            nullSpace?"true":"false"); CHKERRQ(ierr);
 
     ierr = PetscPrintf(PETSC_COMM_WORLD, "Output PETSc Log File ? %s\n", 
             optFileBool?"true":"false"); CHKERRQ(ierr);
@@ -55,7 +57,7 @@ PetscErrorCode StructArgs::checkHelp()
         ierr = PetscPrintf(PETSC_COMM_WORLD, "Necessary Parameters:\n"); CHKERRQ(ierr);
         ierr = PetscPrintf(PETSC_COMM_WORLD, "\t-caseName [string]\n"); CHKERRQ(ierr);
         ierr = PetscPrintf(PETSC_COMM_WORLD,
-                "\t-mode [PETSc or AmgX_GPU or AmgX_CSR]\n"); CHKERRQ(ierr);
+                "\t-mode [PETSc or AmgX_GPU or AmgX_CPU or AmgX_CSR]\n"); CHKERRQ(ierr);
         ierr = PetscPrintf(PETSC_COMM_WORLD,
                 "\t-cfgFileName [config file for solver]\n"); CHKERRQ(ierr);
         ierr = PetscPrintf(PETSC_COMM_WORLD,
@@ -71,6 +73,9 @@ PetscErrorCode StructArgs::checkHelp()
                 "\t-Nruns [number of runs in addition to warm-up run]\n"); CHKERRQ(ierr);
         ierr = PetscPrintf(PETSC_COMM_WORLD, "\t-optFileName "
                 "[file name for outputing PETSc performance log file]\n"); CHKERRQ(ierr);
+        ierr = PetscPrintf(PETSC_COMM_WORLD, "\t-nullSpace "
+                "[remove the constant null space instead of pinning a point; "
+                "not for AmgX_CSR]\n"); CHKERRQ(ierr);
 
         ierr = PetscFinalize(); CHKERRQ(ierr);
 
@@ -116,5 +121,7 @@ PetscErrorCode StructArgs::getArgs()
     ierr = PetscOptionsGetString(nullptr, nullptr, "-optFileName", 
             optFileName, PETSC_MAX_PATH_LEN, &optFileBool); CHKERRQ(ierr);
 
+    ierr = PetscOptionsGetBool(nullptr, nullptr, "-nullSpace", &nullSpace, nullptr); CHKERRQ(ierr);
+
     PetscFunctionReturn(0);
 }
@@ -25,6 +25,8 @@ public:
 
     PetscBool           optFileBool; // indicates if we will output a performance log.
 
+    PetscBool           nullSpace = PETSC_FALSE; // remove the null space instead of pinning a point
+
     char                mode[PETSC_MAX_PATH_LEN],        // either AmgX_GPU, or PETSc
                         cfgFileName[PETSC_MAX_PATH_LEN], // config file
                         optFileName[PETSC_MAX_PATH_LEN], // output file
@@ -22,7 +22,8 @@
  * The boundary condition is all-Neumann BC, except that we pin a point as a
  * reference point (i.e., apply Dirichlet BC to that point) to avoid singular
  * matrix. We choose the point represented by the first row in matrix A as our 
- * reference point.
+ * reference point. With `-nullSpace`, the matrix stays singular, and the
+ * solvers remove its constant null space instead.
  *
  * \author Pi-Yueh Chuang (pychuang@gwu.edu)
  * \date 2015-02-01
@@ -40,6 +41,7 @@
 
 // AmgXWrapper
 # include <AmgXSolver.hpp>
+# include <PCAMGX.hpp>
 
 // headers
 # include "StructArgs.hpp"
@@ -78,6 +80,8 @@ int main(int argc, char **argv)
 
     Mat                 A;      // coefficient matrix
 
+    MatNullSpace        nullSpace = nullptr; // constant null space of A
+
     KSP                 ksp;    // PETSc KSP solver instance
 
     AmgXSolver          amgx;   // AmgX wrapper instance
@@ -101,6 +105,9 @@ int main(int argc, char **argv)
     ierr = PetscInitialize(&argc, &argv, nullptr, nullptr); CHKERRQ(ierr);
     ierr = PetscLogDefaultBegin(); CHKERRQ(ierr);
 
+    // make -pc_type amgx available to the PETSc mode
+    ierr = PCAmgXRegister(); CHKERRQ(ierr);
+
 
     // obtain the rank and size of MPI
     ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
@@ -203,8 +210,25 @@ int main(int argc, char **argv)
 
 
 
-    // pin a point with Dirichlet BC to resolve sinular mat due to all-Neumann BC
-    ierr = fixSingularMat(A, rhs_petsc, u_exact); CHKERRQ(ierr);
+    // solving with raw arrays can not take a null space
+    if (args.nullSpace && std::strcmp(args.mode, "AmgX_CSR") == 0)
+        SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_INCOMP,
+                "-nullSpace is not available in the mode AmgX_CSR.\n");
+
+    if (args.nullSpace)
+    {
+        // the solution is only unique up to a constant; compare the one
+        // with zero mean
+        ierr = MatNullSpaceCreate(PETSC_COMM_WORLD,
+                PETSC_TRUE, 0, nullptr, &nullSpace); CHKERRQ(ierr);
+        ierr = MatSetNullSpace(A, nullSpace); CHKERRQ(ierr);
+        ierr = MatNullSpaceRemove(nullSpace, u_exact); CHKERRQ(ierr);
+    }
+    else
+    {
+        // pin a point with Dirichlet BC to resolve sinular mat due to all-Neumann BC
+        ierr = fixSingularMat(A, rhs_petsc, u_exact); CHKERRQ(ierr);
+    }
 
 
 
@@ -229,7 +253,8 @@ int main(int argc, char **argv)
         // destroy KSP
         ierr = KSPDestroy(&ksp); CHKERRQ(ierr);
     }
-    else if(std::strcmp(args.mode, "AmgX_GPU") == 0) // AmgX GPU mode
+    else if(std::strcmp(args.mode, "AmgX_GPU") == 0 ||
+            std::strcmp(args.mode, "AmgX_CPU") == 0) // AmgX modes
     {
         // AmgX GPU mode
         if (std::strcmp(args.mode, "AmgX_GPU") == 0)
@@ -237,9 +262,12 @@ int main(int argc, char **argv)
             ierr = amgx.initialize(PETSC_COMM_WORLD, "dDDI", args.cfgFileName);
             CHKERRQ(ierr);
         }
-        // AmgX CPU mode (not supported yet)
-        //else if (std::strcmp(args.mode, "AmgX_CPU") == 0)
-        //    amgx.initialize(PETSC_COMM_WORLD, "hDDI", args.cfgFileName);
+        // AmgX CPU mode
+        else if (std::strcmp(args.mode, "AmgX_CPU") == 0)
+        {
+            ierr = amgx.initialize(PETSC_COMM_WORLD, "hDDI", args.cfgFileName);
+            CHKERRQ(ierr);
+        }
         else SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_UNKNOWN_TYPE,
             "Invalid mode: %s\n", args.mode); CHKERRQ(ierr);
 
@@ -249,6 +277,11 @@ int main(int argc, char **argv)
         ierr = amgx.setA(A); CHKERRQ(ierr);
         PetscLogEventEnd(setAEvent, 0, 0, 0, 0);
 
+        if (args.nullSpace)
+        {
+            ierr = amgx.setNullSpace(nullSpace); CHKERRQ(ierr);
+        }
+
         ierr = solve(amgx, A, lhs_petsc, rhs_petsc, u_exact, err,
                 args, warmUpEvent, solvingEvent); CHKERRQ(ierr);
 
@@ -352,6 +385,7 @@ int main(int argc, char **argv)
         ierr = VecDestroy(&u_exact); CHKERRQ(ierr);
         ierr = VecDestroy(&err); CHKERRQ(ierr);
         ierr = MatDestroy(&A); CHKERRQ(ierr);
+        ierr = MatNullSpaceDestroy(&nullSpace); CHKERRQ(ierr);
 
         if (args.Nz > 0) {ierr = VecDestroy(&z); CHKERRQ(ierr); }
 
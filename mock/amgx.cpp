@@ -0,0 +1,854 @@
+/**
+ * \file amgx.cpp
+ * \brief Host-only implementation of the mocked AmgX C API.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <algorithm>
+# include <cmath>
+# include <cstdarg>
+# include <cstdint>
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <fstream>
+# include <map>
+# include <numeric>
+# include <sstream>
+# include <string>
+# include <vector>
+
+// MPI
+# include <mpi.h>
+
+// mock
+# include "amgx_c.h"
+
+
+/** \brief Parameters as `scope:name` -> value; the default scope is bare. */
+struct AMGX_config_handle_struct
+{
+    std::map<std::string, std::string>  params;
+};
+
+/** \brief A private duplicate of the communicator given by the caller. */
+struct AMGX_resources_handle_struct
+{
+    MPI_Comm    comm;
+    int         rank,
+                size;
+};
+
+/** \brief Remembers the caller's partition data until the upload. */
+struct AMGX_distribution_handle_struct
+{
+    AMGX_DIST_PARTITION_INFO    info;
+    const void                  *data;
+};
+
+/** \brief Local rows in CSR; columns index the gathered global vector. */
+struct AMGX_matrix_handle_struct
+{
+    AMGX_resources_handle   rsrc;
+    AMGX_Mode               mode;
+
+    int                     nGlobal,
+                            n;
+
+    std::vector<int>        row,
+                            col,
+                            diag;
+    std::vector<double>     val;
+
+    std::vector<int>        counts,
+                            displs;
+};
+
+struct AMGX_vector_handle_struct
+{
+    AMGX_resources_handle   rsrc;
+    AMGX_Mode               mode;
+    AMGX_matrix_handle      A;
+    std::vector<double>     v;
+};
+
+struct AMGX_solver_handle_struct
+{
+    AMGX_resources_handle   rsrc;
+    AMGX_Mode               mode;
+    AMGX_matrix_handle      A;
+
+    int                     maxIters;
+    double                  tol;
+    std::string             convergence;
+    bool                    monitor,
+                            history,
+                            gridStats;
+
+    std::vector<double>     invDiag;
+
+    int                     iters;
+    AMGX_SOLVE_STATUS       status;
+    std::vector<double>     residuals;
+};
+
+
+namespace
+{
+
+AMGX_print_callback     printFunc = nullptr;
+
+
+/** \brief Print through the registered callback, like AmgX does. */
+void print(const char *format, ...)
+{
+    char        msg[1024];
+    va_list     args;
+
+    va_start(args, format);
+    int n = std::vsnprintf(msg, sizeof(msg), format, args);
+    va_end(args);
+
+    n = std::min(n, static_cast<int>(sizeof(msg)) - 1);
+
+    if (printFunc != nullptr)
+        printFunc(msg, n);
+    else
+        std::fputs(msg, stdout);
+}
+
+
+bool isFloatMatrix(const AMGX_Mode mode)
+{
+    return mode == AMGX_mode_hDFI || mode == AMGX_mode_hFFI ||
+        mode == AMGX_mode_dDFI || mode == AMGX_mode_dFFI;
+}
+
+
+bool isFloatVector(const AMGX_Mode mode)
+{
+    return mode == AMGX_mode_hFFI || mode == AMGX_mode_dFFI;
+}
+
+
+bool isHost(const AMGX_Mode mode)
+{
+    return mode == AMGX_mode_hDDI || mode == AMGX_mode_hDFI ||
+        mode == AMGX_mode_hFFI;
+}
+
+
+/** \brief Copy n values in single or double precision into dst. */
+void load(std::vector<double> &dst, const void *src, int n, bool isFloat)
+{
+    dst.resize(n);
+
+    if (isFloat)
+        std::copy_n(static_cast<const float*>(src), n, dst.begin());
+    else
+        std::copy_n(static_cast<const double*>(src), n, dst.begin());
+}
+
+
+/** \brief Copy src out to n values in single or double precision. */
+void store(const std::vector<double> &src, void *dst, bool isFloat)
+{
+    if (isFloat)
+        std::copy(src.begin(), src.end(), static_cast<float*>(dst));
+    else
+        std::copy(src.begin(), src.end(), static_cast<double*>(dst));
+}
+
+
+std::string trim(const std::string &s)
+{
+    size_t      b = s.find_first_not_of(" \t\r\n"),
+                e = s.find_last_not_of(" \t\r\n");
+
+    return (b == std::string::npos) ? "" : s.substr(b, e - b + 1);
+}
+
+
+/** \brief Parse `[scope:]name[(new_scope)]=value` entries into params. */
+AMGX_RC parse(AMGX_config_handle cfg, const std::string &options)
+{
+    std::string     entry;
+    std::string     text = options;
+
+    // entries are separated by either newlines or commas
+    std::replace(text.begin(), text.end(), ',', '\n');
+
+    std::istringstream  stream(text);
+
+    while (std::getline(stream, entry))
+    {
+        entry = trim(entry.substr(0, entry.find('#')));
+        if (entry.empty()) continue;
+
+        if (entry[0] == '{') return AMGX_RC_NOT_IMPLEMENTED;
+
+        size_t      eq = entry.find('=');
+        if (eq == std::string::npos) return AMGX_RC_BAD_CONFIGURATION;
+
+        std::string     key = trim(entry.substr(0, eq)),
+                        value = trim(entry.substr(eq + 1));
+
+        // a new scope is only remembered for the outermost solver
+        size_t          paren = key.find('(');
+        if (paren != std::string::npos)
+        {
+            std::string     scope = key.substr(paren + 1,
+                    key.find(')') - paren - 1);
+
+            key = key.substr(0, paren);
+            if (key == "solver") cfg->params["solver_scope"] = scope;
+        }
+
+        if (key.compare(0, 8, "default:") == 0) key = key.substr(8);
+
+        cfg->params[key] = value;
+    }
+
+    return AMGX_RC_OK;
+}
+
+
+/** \brief A parameter of the outermost solver, or the given default. */
+std::string param(const AMGX_config_handle cfg, const std::string &name,
+        const std::string &dflt)
+{
+    auto    &p = cfg->params;
+    auto    scope = p.find("solver_scope");
+
+    if (scope != p.end())
+    {
+        auto    it = p.find(scope->second + ":" + name);
+        if (it != p.end()) return it->second;
+    }
+
+    auto    it = p.find(name);
+
+    return (it == p.end()) ? dflt : it->second;
+}
+
+
+/** \brief Whether any scope sets the parameter to the value. */
+bool anyScope(const AMGX_config_handle cfg,
+        const std::string &name, const std::string &value)
+{
+    for (const auto &kv: cfg->params)
+    {
+        const std::string   &k = kv.first;
+        const size_t        n = name.size();
+
+        if (kv.second == value && k.size() >= n &&
+                k.compare(k.size() - n, n, name) == 0 &&
+                (k.size() == n || k[k.size() - n - 1] == ':'))
+            return true;
+    }
+
+    return false;
+}
+
+
+double dot(const AMGX_resources_handle rsrc,
+        const std::vector<double> &x, const std::vector<double> &y)
+{
+    double      local = std::inner_product(x.begin(), x.end(), y.begin(), 0.0),
+                global;
+
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, rsrc->comm);
+
+    return global;
+}
+
+
+/** \brief y = A x, gathering the whole x into the scratch array xg. */
+void spmv(const AMGX_matrix_handle A, const std::vector<double> &x,
+        std::vector<double> &xg, std::vector<double> &y)
+{
+    xg.resize(A->nGlobal);
+
+    MPI_Allgatherv(x.data(), A->n, MPI_DOUBLE, xg.data(),
+            A->counts.data(), A->displs.data(), MPI_DOUBLE, A->rsrc->comm);
+
+    for (int i = 0; i < A->n; ++i)
+    {
+        double  sum = 0.0;
+
+        for (int k = A->row[i]; k < A->row[i+1]; ++k)
+            sum += A->val[k] * xg[A->col[k]];
+
+        y[i] = sum;
+    }
+}
+
+
+/** \brief Upload local rows whose columns are global indices of type T. */
+template <typename T>
+AMGX_RC upload(AMGX_matrix_handle mtx, int n_global, int n, int nnz,
+        int block_dimx, int block_dimy, const int *row_ptrs, const T *col,
+        const void *data, const void *diag_data, const int *part)
+{
+    const AMGX_resources_handle     rsrc = mtx->rsrc;
+
+    if (block_dimx != 1 || block_dimy != 1)
+        return AMGX_RC_NOT_SUPPORTED_BLOCKSIZE;
+    if (diag_data != nullptr) return AMGX_RC_NOT_IMPLEMENTED;
+
+    mtx->nGlobal = n_global;
+    mtx->n = n;
+    mtx->row.assign(row_ptrs, row_ptrs + n + 1);
+    load(mtx->val, data, nnz, isFloatMatrix(mtx->mode));
+
+    mtx->counts.resize(rsrc->size);
+    mtx->displs.assign(rsrc->size + 1, 0);
+
+    MPI_Allgather(&n, 1, MPI_INT, mtx->counts.data(), 1, MPI_INT, rsrc->comm);
+    std::partial_sum(mtx->counts.begin(), mtx->counts.end(),
+            mtx->displs.begin() + 1);
+
+    if (mtx->displs[rsrc->size] != n_global) return AMGX_RC_BAD_PARAMETERS;
+
+    // where each global row ends up in a vector gathered rank by rank; with a
+    // partition vector, the rows of a rank are not necessarily contiguous
+    std::vector<int>    where;
+
+    if (part != nullptr)
+    {
+        std::vector<int>    next(mtx->displs.begin(), mtx->displs.end() - 1);
+
+        where.resize(n_global);
+        for (int g = 0; g < n_global; ++g) where[g] = next[part[g]]++;
+    }
+
+    mtx->col.resize(nnz);
+    mtx->diag.assign(n, -1);
+
+    for (int i = 0; i < n; ++i)
+    {
+        for (int k = row_ptrs[i]; k < row_ptrs[i+1]; ++k)
+        {
+            mtx->col[k] = where.empty() ? col[k] : where[col[k]];
+
+            if (mtx->col[k] == mtx->displs[rsrc->rank] + i) mtx->diag[i] = k;
+        }
+    }
+
+    return AMGX_RC_OK;
+}
+
+
+/** \brief Print the hierarchy of the mock, which has a single level. */
+void printGridStats(const AMGX_solver_handle slv)
+{
+    const AMGX_matrix_handle    A = slv->A;
+
+    long long   local[2] = {A->n, A->row[A->n]},
+                global[2];
+
+    MPI_Reduce(local, global, 2, MPI_LONG_LONG, MPI_SUM, 0, slv->rsrc->comm);
+
+    if (slv->rsrc->rank != 0) return;
+
+    double  mem = (global[1] * (sizeof(double) + sizeof(int)) +
+            global[0] * (sizeof(int) + sizeof(double))) / 1e9;
+
+    print("         Number of Levels: 1\n");
+    print("            LVL         ROWS               NNZ  PARTS    "
+            "SPRSTY       Mem (GB)\n");
+    print("         ------------------------------------------------"
+            "----------------------\n");
+    print("           0(%c)%13lld%18lld%7d%12.3g%15.3g\n",
+            isHost(slv->mode) ? 'H' : 'D', global[0], global[1],
+            slv->rsrc->size, double(global[1]) / global[0] / global[0], mem);
+    print("         ------------------------------------------------"
+            "----------------------\n");
+    print("         Grid Complexity: 1\n");
+    print("         Operator Complexity: 1\n");
+    print("         Total Memory Usage: %g GB\n", mem);
+}
+
+
+/** \brief Jacobi-preconditioned CG on x, starting from the given guess. */
+AMGX_RC pcg(AMGX_solver_handle slv, const std::vector<double> &b,
+        std::vector<double> &x)
+{
+    const AMGX_matrix_handle    A = slv->A;
+    const int                   n = A->n;
+
+    std::vector<double>     r(n), z(n), p(n), Ap(n), xg;
+
+    if (static_cast<int>(b.size()) != n || static_cast<int>(x.size()) != n)
+        return AMGX_RC_BAD_PARAMETERS;
+
+    spmv(A, x, xg, Ap);
+    for (int i = 0; i < n; ++i) r[i] = b[i] - Ap[i];
+    for (int i = 0; i < n; ++i) p[i] = z[i] = slv->invDiag[i] * r[i];
+
+    double      rz = dot(slv->rsrc, r, z),
+                norm = std::sqrt(dot(slv->rsrc, r, r)),
+                norm0 = norm,
+                normMax = norm;
+
+    auto converged = [&] () -> bool
+    {
+        if (slv->convergence == "ABSOLUTE") return norm < slv->tol;
+        if (slv->convergence == "RELATIVE_MAX")
+            return norm < slv->tol * normMax;
+        return norm < slv->tol * norm0;
+    };
+
+    slv->iters = 0;
+    slv->residuals.assign(1, norm);
+
+    bool        done = slv->monitor && converged();
+
+    while (! done && slv->iters < slv->maxIters && rz != 0.0)
+    {
+        spmv(A, p, xg, Ap);
+
+        double  pAp = dot(slv->rsrc, p, Ap);
+        if (pAp == 0.0) break;
+
+        double  alpha = rz / pAp;
+
+        for (int i = 0; i < n; ++i) x[i] += alpha * p[i];
+        for (int i = 0; i < n; ++i) r[i] -= alpha * Ap[i];
+
+        slv->iters += 1;
+
+        if (slv->monitor)
+        {
+            norm = std::sqrt(dot(slv->rsrc, r, r));
+            normMax = std::max(normMax, norm);
+            if (slv->history) slv->residuals.push_back(norm);
+
+            if (! std::isfinite(norm)) break;
+            done = converged();
+        }
+
+        for (int i = 0; i < n; ++i) z[i] = slv->invDiag[i] * r[i];
+
+        double  rzNew = dot(slv->rsrc, r, z);
+
+        for (int i = 0; i < n; ++i) p[i] = z[i] + (rzNew / rz) * p[i];
+        rz = rzNew;
+    }
+
+    // without monitoring, AmgX runs max_iters iterations and claims success
+    if (! slv->monitor || done)
+        slv->status = AMGX_SOLVE_SUCCESS;
+    else if (std::isfinite(norm))
+        slv->status = AMGX_SOLVE_NOT_CONVERGED;
+    else
+        slv->status = AMGX_SOLVE_DIVERGED;
+
+    return AMGX_RC_OK;
+}
+
+} // end of anonymous namespace
+
+
+AMGX_RC AMGX_initialize() { return AMGX_RC_OK; }
+AMGX_RC AMGX_initialize_plugins() { return AMGX_RC_OK; }
+AMGX_RC AMGX_finalize() { return AMGX_RC_OK; }
+AMGX_RC AMGX_finalize_plugins() { return AMGX_RC_OK; }
+AMGX_RC AMGX_install_signal_handler() { return AMGX_RC_OK; }
+AMGX_RC AMGX_reset_signal_handler() { return AMGX_RC_OK; }
+
+
+AMGX_RC AMGX_register_print_callback(AMGX_print_callback func)
+{
+    printFunc = func;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_get_error_string(AMGX_RC err, char *buf, int buf_len)
+{
+    const char  *msg;
+
+    switch (err)
+    {
+        case AMGX_RC_OK: msg = "No error."; break;
+        case AMGX_RC_BAD_PARAMETERS: msg = "Incorrect parameters."; break;
+        case AMGX_RC_BAD_MODE: msg = "Incorrect mode."; break;
+        case AMGX_RC_IO_ERROR: msg = "I/O error."; break;
+        case AMGX_RC_BAD_CONFIGURATION:
+            msg = "Incorrect configuration."; break;
+        case AMGX_RC_NOT_IMPLEMENTED:
+            msg = "Not implemented by the mock AmgX."; break;
+        default: msg = "Unknown error."; break;
+    }
+
+    std::snprintf(buf, buf_len, "%s", msg);
+
+    return AMGX_RC_OK;
+}
+
+
+void AMGX_abort(AMGX_resources_handle rsrc, int err)
+{
+    MPI_Abort((rsrc == nullptr) ? MPI_COMM_WORLD : rsrc->comm, err);
+}
+
+
+AMGX_RC AMGX_config_create(AMGX_config_handle *cfg, const char *options)
+{
+    *cfg = new AMGX_config_handle_struct;
+
+    return parse(*cfg, options);
+}
+
+
+AMGX_RC AMGX_config_create_from_file(
+        AMGX_config_handle *cfg, const char *param_file)
+{
+    std::ifstream       file(param_file);
+    std::stringstream   buffer;
+
+    if (! file.good()) return AMGX_RC_IO_ERROR;
+
+    buffer << file.rdbuf();
+
+    return AMGX_config_create(cfg, buffer.str().c_str());
+}
+
+
+AMGX_RC AMGX_config_add_parameters(
+        AMGX_config_handle *cfg, const char *options)
+{
+    return parse(*cfg, options);
+}
+
+
+AMGX_RC AMGX_config_get_default_number_of_rings(
+        AMGX_config_handle cfg, int *num_import_rings)
+{
+    // classical AMG needs two rings, aggregation one
+    *num_import_rings = anyScope(cfg, "algorithm", "CLASSICAL") ? 2 : 1;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_config_destroy(AMGX_config_handle cfg)
+{
+    delete cfg;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_resources_create(AMGX_resources_handle *rsrc,
+        AMGX_config_handle cfg, void *comm, int device_num, const int *devices)
+{
+    *rsrc = new AMGX_resources_handle_struct;
+
+    MPI_Comm_dup((comm == nullptr) ?
+            MPI_COMM_SELF : *static_cast<MPI_Comm*>(comm), &(*rsrc)->comm);
+    MPI_Comm_rank((*rsrc)->comm, &(*rsrc)->rank);
+    MPI_Comm_size((*rsrc)->comm, &(*rsrc)->size);
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_resources_destroy(AMGX_resources_handle rsrc)
+{
+    MPI_Comm_free(&rsrc->comm);
+    delete rsrc;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_distribution_create(
+        AMGX_distribution_handle *dist, AMGX_config_handle cfg)
+{
+    *dist = new AMGX_distribution_handle_struct{
+        AMGX_DIST_PARTITION_OFFSETS, nullptr};
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_distribution_destroy(AMGX_distribution_handle dist)
+{
+    delete dist;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_distribution_set_partition_data(AMGX_distribution_handle dist,
+        AMGX_DIST_PARTITION_INFO info, const void *partition_data)
+{
+    dist->info = info;
+    dist->data = partition_data;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_matrix_create(
+        AMGX_matrix_handle *mtx, AMGX_resources_handle rsrc, AMGX_Mode mode)
+{
+    *mtx = new AMGX_matrix_handle_struct;
+
+    (*mtx)->rsrc = rsrc;
+    (*mtx)->mode = mode;
+    (*mtx)->nGlobal = (*mtx)->n = 0;
+    (*mtx)->row.assign(1, 0);
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_matrix_destroy(AMGX_matrix_handle mtx)
+{
+    delete mtx;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_matrix_upload_all_global_32(AMGX_matrix_handle mtx,
+        int n_global, int n, int nnz, int block_dimx, int block_dimy,
+        const int *row_ptrs, const int *col_indices_global,
+        const void *data, const void *diag_data,
+        int allocated_halo_depth, int num_import_rings,
+        const int *partition_vector)
+{
+    return upload(mtx, n_global, n, nnz, block_dimx, block_dimy, row_ptrs,
+            col_indices_global, data, diag_data, partition_vector);
+}
+
+
+AMGX_RC AMGX_matrix_upload_distributed(AMGX_matrix_handle mtx,
+        int n_global, int n, int nnz, int block_dimx, int block_dimy,
+        const int *row_ptrs, const void *col_indices_global,
+        const void *data, const void *diag_data,
+        AMGX_distribution_handle distribution)
+{
+    // rows are contiguous with offsets, so only a partition vector matters
+    const int   *part = (distribution != nullptr &&
+            distribution->info == AMGX_DIST_PARTITION_VECTOR) ?
+        static_cast<const int*>(distribution->data) : nullptr;
+
+    return upload(mtx, n_global, n, nnz, block_dimx, block_dimy, row_ptrs,
+            static_cast<const int64_t*>(col_indices_global), data, diag_data,
+            part);
+}
+
+
+AMGX_RC AMGX_matrix_replace_coefficients(AMGX_matrix_handle mtx,
+        int n, int nnz, const void *data, const void *diag_data)
+{
+    if (n != mtx->n || nnz != mtx->row[mtx->n]) return AMGX_RC_BAD_PARAMETERS;
+    if (diag_data != nullptr) return AMGX_RC_NOT_IMPLEMENTED;
+
+    load(mtx->val, data, nnz, isFloatMatrix(mtx->mode));
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_matrix_get_size(const AMGX_matrix_handle mtx,
+        int *n, int *block_dimx, int *block_dimy)
+{
+    *n = mtx->n;
+    *block_dimx = *block_dimy = 1;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_matrix_get_nnz(const AMGX_matrix_handle mtx, int *nnz)
+{
+    *nnz = mtx->row[mtx->n];
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_vector_create(
+        AMGX_vector_handle *vec, AMGX_resources_handle rsrc, AMGX_Mode mode)
+{
+    *vec = new AMGX_vector_handle_struct;
+
+    (*vec)->rsrc = rsrc;
+    (*vec)->mode = mode;
+    (*vec)->A = nullptr;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_vector_destroy(AMGX_vector_handle vec)
+{
+    delete vec;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_vector_upload(
+        AMGX_vector_handle vec, int n, int block_dim, const void *data)
+{
+    if (block_dim != 1) return AMGX_RC_NOT_SUPPORTED_BLOCKSIZE;
+
+    load(vec->v, data, n, isFloatVector(vec->mode));
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_vector_set_zero(AMGX_vector_handle vec, int n, int block_dim)
+{
+    if (block_dim != 1) return AMGX_RC_NOT_SUPPORTED_BLOCKSIZE;
+
+    vec->v.assign(n, 0.0);
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_vector_download(const AMGX_vector_handle vec, void *data)
+{
+    store(vec->v, data, isFloatVector(vec->mode));
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_vector_get_size(
+        const AMGX_vector_handle vec, int *n, int *block_dim)
+{
+    *n = vec->v.size();
+    *block_dim = 1;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_vector_bind(AMGX_vector_handle vec, const AMGX_matrix_handle mtx)
+{
+    vec->A = mtx;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_solver_create(AMGX_solver_handle *slv,
+        AMGX_resources_handle rsrc, AMGX_Mode mode,
+        const AMGX_config_handle cfg_solver)
+{
+    AMGX_solver_handle  s = new AMGX_solver_handle_struct;
+
+    // defaults are those of AmgX
+    s->rsrc = rsrc;
+    s->mode = mode;
+    s->A = nullptr;
+    s->maxIters = std::atoi(param(cfg_solver, "max_iters", "100").c_str());
+    s->tol = std::atof(param(cfg_solver, "tolerance", "1e-12").c_str());
+    s->convergence = param(cfg_solver, "convergence", "ABSOLUTE");
+    s->monitor = param(cfg_solver, "monitor_residual", "0") == "1";
+    s->history = s->monitor &&
+        param(cfg_solver, "store_res_history", "0") == "1";
+    s->gridStats = anyScope(cfg_solver, "print_grid_stats", "1");
+    s->iters = 0;
+    s->status = AMGX_SOLVE_SUCCESS;
+
+    *slv = s;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_solver_destroy(AMGX_solver_handle slv)
+{
+    delete slv;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_solver_setup(AMGX_solver_handle slv, AMGX_matrix_handle mtx)
+{
+    slv->A = mtx;
+    slv->invDiag.resize(mtx->n);
+
+    // rows without a (nonzero) diagonal are left unpreconditioned
+    for (int i = 0; i < mtx->n; ++i)
+    {
+        double  d = (mtx->diag[i] < 0) ? 0.0 : mtx->val[mtx->diag[i]];
+
+        slv->invDiag[i] = (d == 0.0) ? 1.0 : 1.0 / d;
+    }
+
+    if (slv->gridStats) printGridStats(slv);
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_solver_resetup(AMGX_solver_handle slv, AMGX_matrix_handle mtx)
+{
+    return AMGX_solver_setup(slv, mtx);
+}
+
+
+AMGX_RC AMGX_solver_solve(
+        AMGX_solver_handle slv, AMGX_vector_handle rhs, AMGX_vector_handle sol)
+{
+    if (slv->A == nullptr) return AMGX_RC_BAD_PARAMETERS;
+
+    return pcg(slv, rhs->v, sol->v);
+}
+
+
+AMGX_RC AMGX_solver_solve_with_0_initial_guess(
+        AMGX_solver_handle slv, AMGX_vector_handle rhs, AMGX_vector_handle sol)
+{
+    if (slv->A == nullptr) return AMGX_RC_BAD_PARAMETERS;
+
+    sol->v.assign(slv->A->n, 0.0);
+
+    return pcg(slv, rhs->v, sol->v);
+}
+
+
+AMGX_RC AMGX_solver_get_iterations_number(AMGX_solver_handle slv, int *n)
+{
+    *n = slv->iters;
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_solver_get_iteration_residual(
+        AMGX_solver_handle slv, int it, int idx, double *res)
+{
+    if (! slv->history || idx != 0 || it < 0 ||
+            it >= static_cast<int>(slv->residuals.size()))
+        return AMGX_RC_BAD_PARAMETERS;
+
+    *res = slv->residuals[it];
+
+    return AMGX_RC_OK;
+}
+
+
+AMGX_RC AMGX_solver_get_status(AMGX_solver_handle slv, AMGX_SOLVE_STATUS *st)
+{
+    *st = slv->status;
+
+    return AMGX_RC_OK;
+}
@@ -0,0 +1,190 @@
+/**
+ * \file amgx_c.h
+ * \brief The subset of the AmgX C API implemented by the host-only mock.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ *
+ * The declarations follow the real amgx_c.h, so the wrapper compiles against
+ * either one unchanged. Behind them is a Jacobi-preconditioned CG on the host
+ * that understands the flat `scope:name=value` configuration format; JSON
+ * configuration files are not supported.
+ */
+
+
+# pragma once
+
+# include <stdio.h>
+
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+
+/** \brief Return codes of AmgX API calls. */
+typedef enum
+{
+    AMGX_RC_OK = 0,
+    AMGX_RC_BAD_PARAMETERS = 1,
+    AMGX_RC_UNKNOWN = 2,
+    AMGX_RC_NOT_SUPPORTED_TARGET = 3,
+    AMGX_RC_NOT_SUPPORTED_BLOCKSIZE = 4,
+    AMGX_RC_CUDA_FAILURE = 5,
+    AMGX_RC_THRUST_FAILURE = 6,
+    AMGX_RC_NO_MEMORY = 7,
+    AMGX_RC_IO_ERROR = 8,
+    AMGX_RC_BAD_MODE = 9,
+    AMGX_RC_CORE = 10,
+    AMGX_RC_PLUGIN = 11,
+    AMGX_RC_BAD_CONFIGURATION = 12,
+    AMGX_RC_NOT_IMPLEMENTED = 13,
+    AMGX_RC_LICENSE_NOT_FOUND = 14,
+    AMGX_RC_INTERNAL = 15
+} AMGX_RC;
+
+/** \brief Outcomes of a solve. */
+typedef enum
+{
+    AMGX_SOLVE_SUCCESS = 0,
+    AMGX_SOLVE_FAILED = 1,
+    AMGX_SOLVE_DIVERGED = 2,
+    AMGX_SOLVE_NOT_CONVERGED = 2
+} AMGX_SOLVE_STATUS;
+
+/** \brief Memory space (h/d), vector, matrix and index precisions. */
+typedef enum
+{
+    AMGX_mode_hDDI,
+    AMGX_mode_hDFI,
+    AMGX_mode_hFFI,
+    AMGX_mode_dDDI,
+    AMGX_mode_dDFI,
+    AMGX_mode_dFFI
+} AMGX_Mode;
+
+/** \brief How AMGX_distribution_set_partition_data interprets its data. */
+typedef enum
+{
+    AMGX_DIST_PARTITION_VECTOR = 0,
+    AMGX_DIST_PARTITION_OFFSETS = 1
+} AMGX_DIST_PARTITION_INFO;
+
+typedef struct AMGX_config_handle_struct *AMGX_config_handle;
+typedef struct AMGX_resources_handle_struct *AMGX_resources_handle;
+typedef struct AMGX_matrix_handle_struct *AMGX_matrix_handle;
+typedef struct AMGX_vector_handle_struct *AMGX_vector_handle;
+typedef struct AMGX_solver_handle_struct *AMGX_solver_handle;
+typedef struct AMGX_distribution_handle_struct *AMGX_distribution_handle;
+
+typedef void (*AMGX_print_callback)(const char *msg, int length);
+
+
+// library
+AMGX_RC AMGX_initialize();
+AMGX_RC AMGX_initialize_plugins();
+AMGX_RC AMGX_finalize();
+AMGX_RC AMGX_finalize_plugins();
+AMGX_RC AMGX_register_print_callback(AMGX_print_callback func);
+AMGX_RC AMGX_install_signal_handler();
+AMGX_RC AMGX_reset_signal_handler();
+AMGX_RC AMGX_get_error_string(AMGX_RC err, char *buf, int buf_len);
+void AMGX_abort(AMGX_resources_handle rsrc, int err);
+
+// configuration
+AMGX_RC AMGX_config_create(AMGX_config_handle *cfg, const char *options);
+AMGX_RC AMGX_config_create_from_file(
+        AMGX_config_handle *cfg, const char *param_file);
+AMGX_RC AMGX_config_add_parameters(
+        AMGX_config_handle *cfg, const char *options);
+AMGX_RC AMGX_config_get_default_number_of_rings(
+        AMGX_config_handle cfg, int *num_import_rings);
+AMGX_RC AMGX_config_destroy(AMGX_config_handle cfg);
+
+// resources; comm points to an MPI_Comm
+AMGX_RC AMGX_resources_create(AMGX_resources_handle *rsrc,
+        AMGX_config_handle cfg, void *comm, int device_num, const int *devices);
+AMGX_RC AMGX_resources_destroy(AMGX_resources_handle rsrc);
+
+// distribution
+AMGX_RC AMGX_distribution_create(
+        AMGX_distribution_handle *dist, AMGX_config_handle cfg);
+AMGX_RC AMGX_distribution_destroy(AMGX_distribution_handle dist);
+AMGX_RC AMGX_distribution_set_partition_data(AMGX_distribution_handle dist,
+        AMGX_DIST_PARTITION_INFO info, const void *partition_data);
+
+// matrix
+AMGX_RC AMGX_matrix_create(
+        AMGX_matrix_handle *mtx, AMGX_resources_handle rsrc, AMGX_Mode mode);
+AMGX_RC AMGX_matrix_destroy(AMGX_matrix_handle mtx);
+AMGX_RC AMGX_matrix_upload_all_global_32(AMGX_matrix_handle mtx,
+        int n_global, int n, int nnz, int block_dimx, int block_dimy,
+        const int *row_ptrs, const int *col_indices_global,
+        const void *data, const void *diag_data,
+        int allocated_halo_depth, int num_import_rings,
+        const int *partition_vector);
+// column indices are 64-bit
+AMGX_RC AMGX_matrix_upload_distributed(AMGX_matrix_handle mtx,
+        int n_global, int n, int nnz, int block_dimx, int block_dimy,
+        const int *row_ptrs, const void *col_indices_global,
+        const void *data, const void *diag_data,
+        AMGX_distribution_handle distribution);
+AMGX_RC AMGX_matrix_replace_coefficients(AMGX_matrix_handle mtx,
+        int n, int nnz, const void *data, const void *diag_data);
+AMGX_RC AMGX_matrix_get_size(const AMGX_matrix_handle mtx,
+        int *n, int *block_dimx, int *block_dimy);
+AMGX_RC AMGX_matrix_get_nnz(const AMGX_matrix_handle mtx, int *nnz);
+
+// vector
+AMGX_RC AMGX_vector_create(
+        AMGX_vector_handle *vec, AMGX_resources_handle rsrc, AMGX_Mode mode);
+AMGX_RC AMGX_vector_destroy(AMGX_vector_handle vec);
+AMGX_RC AMGX_vector_upload(
+        AMGX_vector_handle vec, int n, int block_dim, const void *data);
+AMGX_RC AMGX_vector_set_zero(AMGX_vector_handle vec, int n, int block_dim);
+AMGX_RC AMGX_vector_download(const AMGX_vector_handle vec, void *data);
+AMGX_RC AMGX_vector_get_size(
+        const AMGX_vector_handle vec, int *n, int *block_dim);
+AMGX_RC AMGX_vector_bind(AMGX_vector_handle vec, const AMGX_matrix_handle mtx);
+
+// solver
+AMGX_RC AMGX_solver_create(AMGX_solver_handle *slv,
+        AMGX_resources_handle rsrc, AMGX_Mode mode,
+        const AMGX_config_handle cfg_solver);
+AMGX_RC AMGX_solver_destroy(AMGX_solver_handle slv);
+AMGX_RC AMGX_solver_setup(AMGX_solver_handle slv, AMGX_matrix_handle mtx);
+AMGX_RC AMGX_solver_resetup(AMGX_solver_handle slv, AMGX_matrix_handle mtx);
+AMGX_RC AMGX_solver_solve(
+        AMGX_solver_handle slv, AMGX_vector_handle rhs, AMGX_vector_handle sol);
+AMGX_RC AMGX_solver_solve_with_0_initial_guess(
+        AMGX_solver_handle slv, AMGX_vector_handle rhs, AMGX_vector_handle sol);
+AMGX_RC AMGX_solver_get_iterations_number(AMGX_solver_handle slv, int *n);
+AMGX_RC AMGX_solver_get_iteration_residual(
+        AMGX_solver_handle slv, int it, int idx, double *res);
+AMGX_RC AMGX_solver_get_status(
+        AMGX_solver_handle slv, AMGX_SOLVE_STATUS *st);
+
+
+# ifdef __cplusplus
+}
+# endif
+
+
+/** \brief Abort with a message when an AmgX call does not return AMGX_RC_OK. */
+# define AMGX_SAFE_CALL(rc)                                                 \
+{                                                                           \
+    AMGX_RC err;                                                            \
+    char msg[4096];                                                         \
+    switch (err = (rc))                                                     \
+    {                                                                       \
+        case AMGX_RC_OK:                                                    \
+            break;                                                          \
+        default:                                                            \
+            fprintf(stderr, "AMGX ERROR: file %s line %6d\n",               \
+                    __FILE__, __LINE__);                                    \
+            AMGX_get_error_string(err, msg, 4096);                          \
+            fprintf(stderr, "AMGX ERROR: %s\n", msg);                       \
+            AMGX_abort(NULL, 1);                                            \
+            break;                                                          \
+    }                                                                       \
+}
@@ -0,0 +1,300 @@
+/**
+ * \file cuda_runtime.cpp
+ * \brief Host-only implementation of the mocked CUDA runtime API.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <map>
+# include <mutex>
+# include <string>
+
+// POSIX
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+
+// mock
+# include "cuda_runtime.h"
+
+
+namespace
+{
+
+/** \brief A mapped shared memory object; owners created it with cudaMalloc. */
+struct Allocation
+{
+    size_t          bytes;
+    bool            owner;
+    std::string     name;
+};
+
+std::mutex                              lock;
+std::map<const char*, Allocation>       allocations;
+unsigned long                           nCreated = 0;
+
+thread_local int                        currentDevice = 0;
+
+
+/** \brief Find the allocation containing ptr, or allocations.end(). */
+std::map<const char*, Allocation>::iterator find(const void *ptr)
+{
+    const char      *p = static_cast<const char*>(ptr);
+
+    auto            it = allocations.upper_bound(p);
+
+    if (it == allocations.begin()) return allocations.end();
+
+    --it;
+    if (p >= it->first + it->second.bytes) return allocations.end();
+
+    return it;
+}
+
+
+/** \brief Map a shared memory object and register the mapping. */
+cudaError_t map(const std::string &name, size_t bytes, bool owner, void **ptr)
+{
+    int     fd = shm_open(name.c_str(),
+            owner ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+
+    if (fd == -1)
+        return owner ? cudaErrorMemoryAllocation : cudaErrorInvalidValue;
+
+    struct stat     st;
+
+    if (owner)
+    {
+        // mmap refuses empty mappings
+        if (ftruncate(fd, (bytes == 0) ? 1 : bytes) != 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            return cudaErrorMemoryAllocation;
+        }
+    }
+    else if (fstat(fd, &st) == 0)
+        bytes = st.st_size;
+
+    void    *p = mmap(nullptr, (bytes == 0) ? 1 : bytes,
+            PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (p == MAP_FAILED)
+    {
+        if (owner) shm_unlink(name.c_str());
+        return owner ?
+            cudaErrorMemoryAllocation : cudaErrorMapBufferObjectFailed;
+    }
+
+    allocations[static_cast<const char*>(p)] =
+        {(bytes == 0) ? 1 : bytes, owner, name};
+    *ptr = p;
+
+    return cudaSuccess;
+}
+
+} // end of anonymous namespace
+
+
+const char *cudaGetErrorString(cudaError_t error)
+{
+    switch (error)
+    {
+        case cudaSuccess: return "no error";
+        case cudaErrorInvalidValue: return "invalid argument";
+        case cudaErrorMemoryAllocation: return "out of memory";
+        case cudaErrorInvalidDevice: return "invalid device ordinal";
+        case cudaErrorNoDevice: return "no CUDA-capable device is detected";
+        case cudaErrorMapBufferObjectFailed:
+            return "mapping of buffer object failed";
+    }
+
+    return "unrecognized error code";
+}
+
+
+cudaError_t cudaGetLastError()
+{
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaGetDeviceCount(int *count)
+{
+    const char      *env = std::getenv("AMGX_MOCK_DEVICES");
+
+    *count = (env == nullptr) ? 1 : std::atoi(env);
+
+    return (*count > 0) ? cudaSuccess : cudaErrorNoDevice;
+}
+
+
+cudaError_t cudaSetDevice(int device)
+{
+    int     count;
+
+    cudaGetDeviceCount(&count);
+
+    if (device < 0 || device >= count) return cudaErrorInvalidDevice;
+
+    currentDevice = device;
+
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaGetDevice(int *device)
+{
+    *device = currentDevice;
+
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaDeviceSynchronize()
+{
+    // everything the mock does is synchronous
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaMalloc(void **devPtr, size_t size)
+{
+    std::lock_guard<std::mutex>     guard(lock);
+
+    // names must be unique across the processes sharing the node
+    char    name[64];
+    std::snprintf(name, sizeof(name), "/amgxmock.%ld.%lu",
+            static_cast<long>(getpid()), nCreated++);
+
+    return map(name, size, true, devPtr);
+}
+
+
+cudaError_t cudaFree(void *devPtr)
+{
+    if (devPtr == nullptr) return cudaSuccess;
+
+    std::lock_guard<std::mutex>     guard(lock);
+
+    auto    it = allocations.find(static_cast<const char*>(devPtr));
+
+    if (it == allocations.end() || ! it->second.owner)
+        return cudaErrorInvalidValue;
+
+    munmap(devPtr, it->second.bytes);
+    shm_unlink(it->second.name.c_str());
+    allocations.erase(it);
+
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaMemcpy(
+        void *dst, const void *src, size_t count, cudaMemcpyKind kind)
+{
+    std::memcpy(dst, src, count);
+
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaMemcpyAsync(void *dst, const void *src, size_t count,
+        cudaMemcpyKind kind, cudaStream_t stream)
+{
+    return cudaMemcpy(dst, src, count, kind);
+}
+
+
+cudaError_t cudaStreamCreateWithFlags(cudaStream_t *stream, unsigned int flags)
+{
+    // any unique non-null value will do
+    *stream = reinterpret_cast<cudaStream_t>(new char);
+
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaStreamDestroy(cudaStream_t stream)
+{
+    delete reinterpret_cast<char*>(stream);
+
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaStreamSynchronize(cudaStream_t stream)
+{
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaPointerGetAttributes(
+        struct cudaPointerAttributes *attributes, const void *ptr)
+{
+    std::lock_guard<std::mutex>     guard(lock);
+
+    // like CUDA 11 and later, plain host memory is not an error
+    bool    device = (find(ptr) != allocations.end());
+
+    attributes->type =
+        device ? cudaMemoryTypeDevice : cudaMemoryTypeUnregistered;
+    attributes->device = device ? currentDevice : -2;
+    attributes->devicePointer = device ? const_cast<void*>(ptr) : nullptr;
+    attributes->hostPointer = device ? nullptr : const_cast<void*>(ptr);
+
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaIpcGetMemHandle(cudaIpcMemHandle_t *handle, void *devPtr)
+{
+    std::lock_guard<std::mutex>     guard(lock);
+
+    auto    it = allocations.find(static_cast<const char*>(devPtr));
+
+    if (it == allocations.end()) return cudaErrorInvalidValue;
+
+    std::memset(handle->reserved, 0, sizeof(handle->reserved));
+    std::strncpy(handle->reserved, it->second.name.c_str(),
+            sizeof(handle->reserved) - 1);
+
+    return cudaSuccess;
+}
+
+
+cudaError_t cudaIpcOpenMemHandle(
+        void **devPtr, cudaIpcMemHandle_t handle, unsigned int flags)
+{
+    std::lock_guard<std::mutex>     guard(lock);
+
+    std::string     name(handle.reserved,
+            strnlen(handle.reserved, sizeof(handle.reserved)));
+
+    return map(name, 0, false, devPtr);
+}
+
+
+cudaError_t cudaIpcCloseMemHandle(void *devPtr)
+{
+    std::lock_guard<std::mutex>     guard(lock);
+
+    auto    it = allocations.find(static_cast<const char*>(devPtr));
+
+    if (it == allocations.end() || it->second.owner)
+        return cudaErrorInvalidValue;
+
+    munmap(devPtr, it->second.bytes);
+    allocations.erase(it);
+
+    return cudaSuccess;
+}
@@ -0,0 +1,105 @@
+/**
+ * \file cuda_runtime.h
+ * \brief The subset of the CUDA runtime API implemented by the host-only mock.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ *
+ * "Device" memory is host memory in POSIX shared memory, so that IPC handles
+ * work between the processes of a node just like they do on a real GPU. The
+ * number of devices per node is read from the environment variable
+ * AMGX_MOCK_DEVICES and defaults to 1.
+ */
+
+
+# pragma once
+
+# include <stddef.h>
+
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+
+typedef enum
+{
+    cudaSuccess = 0,
+    cudaErrorInvalidValue = 1,
+    cudaErrorMemoryAllocation = 2,
+    cudaErrorInvalidDevice = 101,
+    cudaErrorNoDevice = 100,
+    cudaErrorMapBufferObjectFailed = 205
+} cudaError_t;
+
+typedef enum
+{
+    cudaMemoryTypeUnregistered = 0,
+    cudaMemoryTypeHost = 1,
+    cudaMemoryTypeDevice = 2,
+    cudaMemoryTypeManaged = 3
+} cudaMemoryType;
+
+typedef enum
+{
+    cudaMemcpyHostToHost = 0,
+    cudaMemcpyHostToDevice = 1,
+    cudaMemcpyDeviceToHost = 2,
+    cudaMemcpyDeviceToDevice = 3,
+    cudaMemcpyDefault = 4
+} cudaMemcpyKind;
+
+struct cudaPointerAttributes
+{
+    cudaMemoryType  type;
+    int             device;
+    void            *devicePointer;
+    void            *hostPointer;
+};
+
+/** \brief Carries the name of the shared memory object of an allocation. */
+typedef struct cudaIpcMemHandle_st
+{
+    char    reserved[64];
+} cudaIpcMemHandle_t;
+
+# define cudaIpcMemLazyEnablePeerAccess 0x01
+
+/** \brief Streams of the mock are only names; all work is synchronous. */
+typedef struct CUstream_st *cudaStream_t;
+
+# define cudaStreamDefault 0x00
+# define cudaStreamNonBlocking 0x01
+
+
+const char *cudaGetErrorString(cudaError_t error);
+cudaError_t cudaGetLastError();
+
+cudaError_t cudaGetDeviceCount(int *count);
+cudaError_t cudaSetDevice(int device);
+cudaError_t cudaGetDevice(int *device);
+cudaError_t cudaDeviceSynchronize();
+
+cudaError_t cudaMalloc(void **devPtr, size_t size);
+cudaError_t cudaFree(void *devPtr);
+cudaError_t cudaMemcpy(
+        void *dst, const void *src, size_t count, cudaMemcpyKind kind);
+cudaError_t cudaMemcpyAsync(void *dst, const void *src, size_t count,
+        cudaMemcpyKind kind, cudaStream_t stream);
+
+cudaError_t cudaStreamCreateWithFlags(
+        cudaStream_t *stream, unsigned int flags);
+cudaError_t cudaStreamDestroy(cudaStream_t stream);
+cudaError_t cudaStreamSynchronize(cudaStream_t stream);
+cudaError_t cudaPointerGetAttributes(
+        struct cudaPointerAttributes *attributes, const void *ptr);
+
+cudaError_t cudaIpcGetMemHandle(cudaIpcMemHandle_t *handle, void *devPtr);
+cudaError_t cudaIpcOpenMemHandle(
+        void **devPtr, cudaIpcMemHandle_t handle, unsigned int flags);
+cudaError_t cudaIpcCloseMemHandle(void *devPtr);
+
+
+# ifdef __cplusplus
+}
+# endif
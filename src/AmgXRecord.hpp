@@ -0,0 +1,102 @@
+/**
+ * \file AmgXRecord.hpp
+ * \brief Layout of the files written by `-amgx_record`.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ *
+ * Every rank writes its own file: a Header, then one Entry per call to
+ * `setA`, `updateA`, or `solve`, each followed by its payload. All integers
+ * in payloads are PetscInt and all values PetscScalar, as given by the
+ * header. Payloads are:
+ *
+ * - SetAMat, SetARaw: `nGlobalRows, nLocalRows, nLocalNz, hasPartData`,
+ *   row offsets (`nLocalRows + 1`), global column indices (`nLocalNz`),
+ *   values (`nLocalNz`), and, if `hasPartData`, the partition vector
+ *   (`nGlobalRows`). For SetAMat, these are the local rows of the PETSc
+ *   matrix as the application owns them.
+ * - UpdateA, UpdateAMat: `nLocalRows, nLocalNz, nChanged`. If `nChanged` is
+ *   negative, all values follow. Otherwise, the positions (`nChanged`) and the
+ *   new values (`nChanged`) of the entries that differ from the previous call
+ *   follow. For UpdateAMat, values are in the order of SetAMat.
+ * - SolveVec, SolveRaw: `nRows`, the initial guess (`nRows`), and the
+ *   right-hand side (`nRows`).
+ * - UpdateAFloat, SolveRawFloat: as UpdateA and SolveRaw, for the overloads
+ *   taking float. The values are still PetscScalar, widened exactly from the
+ *   floats of the call.
+ */
+
+
+# pragma once
+
+// PETSc
+# include <petscsys.h>
+
+
+namespace AmgXRecord
+{
+
+/** \brief The first bytes of every record file. */
+const char      magic[8] = "AMGXREC";
+
+/** \brief Version of the layout described here. */
+const int       version = 2;
+
+/** \brief The recorded calls. */
+enum Kind
+{
+    SetAMat = 0,    ///< setA with a PETSc Mat.
+    SetARaw,        ///< setA with CSR arrays.
+    UpdateA,        ///< updateA.
+    SolveVec,       ///< solve with PETSc Vecs.
+    SolveRaw,       ///< solve with raw arrays.
+    UpdateAMat,     ///< updateA with a PETSc Mat.
+    UpdateAFloat,   ///< updateA with float values; since version 2.
+    SolveRawFloat   ///< solve with float arrays; since version 2.
+};
+
+/** \brief What a record file starts with. */
+struct Header
+{
+    /** \brief Always \ref AmgXRecord::magic "magic". */
+    char        magic[8];
+
+    /** \brief Always \ref AmgXRecord::version "version". */
+    int         version;
+
+    /** \brief Rank in the communicator given to `initialize`. */
+    int         rank;
+
+    /** \brief Size of the communicator given to `initialize`. */
+    int         size;
+
+    /** \brief sizeof(PetscInt) of the recording application. */
+    int         intSize;
+
+    /** \brief sizeof(PetscScalar) of the recording application. */
+    int         scalarSize;
+
+    /** \brief AmgX mode, e.g., dDDI. */
+    char        mode[8];
+
+    /** \brief Path to the AmgX configuration file. */
+    char        config[PETSC_MAX_PATH_LEN];
+};
+
+/** \brief What every recorded call starts with. */
+struct Entry
+{
+    /** \brief A \ref AmgXRecord::Kind "Kind". */
+    int         kind;
+
+    /** \brief Whether the arrays of the call were in device memory. */
+    int         onDevice;
+
+    /** \brief Begin time (s) relative to `initialize`. */
+    double      begin;
+
+    /** \brief End time (s) relative to `initialize`. */
+    double      end;
+};
+
+} // end of namespace AmgXRecord
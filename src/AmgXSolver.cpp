@@ -15,5 +15,43 @@
 // initialize AmgXSolver::count to 0
 int AmgXSolver::count = 0;
 
-// initialize AmgXSolver::rsrc to nullptr;
-AMGX_resources_handle AmgXSolver::rsrc = nullptr;
+// initialize AmgXSolver::amgxCount to 0
+int AmgXSolver::amgxCount = 0;
+
+// initialize AmgXSolver::registry to empty
+std::vector<AmgXSolver::SharedRsrc> AmgXSolver::registry;
+
+// initialize AmgXSolver::topologyKeys to invalid keys
+int AmgXSolver::topologyKeys[2] = {MPI_KEYVAL_INVALID, MPI_KEYVAL_INVALID};
+
+// initialize AmgXSolver::logThread to no thread
+std::thread::id AmgXSolver::logThread;
+
+// initialize AmgXSolver::classId to 0
+PetscClassId AmgXSolver::classId = 0;
+
+// initialize AmgXSolver::events to zeros
+PetscLogEvent AmgXSolver::events[AmgXSolver::nEvents] = {0};
+
+// initialize AmgXSolver::eventsRegistered to false
+PetscBool AmgXSolver::eventsRegistered = PETSC_FALSE;
+
+// initialize AmgXSolver::eventNames; short enough to fit in -log_view
+const char *AmgXSolver::eventNames[AmgXSolver::nEvents] = {
+    "AmgXGetDevIS", "AmgXRedistMat", "AmgXGetRawData", "AmgXGetPartData",
+    "AmgXConsolidate", "AmgXUploadA", "AmgXSetup", "AmgXResetup",
+    "AmgXVecScatter", "AmgXVecUpload", "AmgXSolve", "AmgXVecDownload",
+    "AmgXMPIWait"};
+
+// initialize AmgXSolver::serialCount to 0
+int AmgXSolver::serialCount = 0;
+
+// initialize AmgXSolver::statNames
+const char *AmgXSolver::statNames[AmgXSolver::nStats] = {
+    "setup", "resetup", "solve", "iterations"};
+
+// initialize AmgXSolver::printCapture to nullptr
+thread_local std::string *AmgXSolver::printCapture = nullptr;
+
+// initialize AmgXSolver::printMuted to false
+thread_local bool AmgXSolver::printMuted = false;
@@ -15,13 +15,17 @@
 #include <cuda_runtime.h>
 
 // STL
+# include <cstdio>
+# include <limits>
 # include <string>
+# include <thread>
 # include <vector>
 
 // AmgX
 # include <amgx_c.h>
 
 // PETSc
+# include <petscksp.h>
 # include <petscmat.h>
 # include <petscvec.h>
 
@@ -88,6 +92,92 @@ class AmgXSolver
 {
     public:
 
+        /** \brief How `initialize` reads the AmgX configuration. */
+        enum class ConfigSource
+        {
+            /** \brief A path to a configuration file. Only the rank 0 reads
+             *         it, and broadcasts its content. */
+            File,
+
+            /** \brief The configuration itself, e.g.,
+             *         `"config_version=2, solver=AMG, max_levels=20"`. */
+            String,
+
+            /** \brief A PETSc options prefix, e.g., `amgx_prec`. Each option
+             *         `-amgx_prec:<name> <value>` gives the AmgX parameter
+             *         `<name>=<value>`. */
+            Options
+        };
+
+        /** \brief Outcome and timings of a single solve.
+         *
+         * The status, the number of iterations, and the residual history are
+         * the same on all ranks. The timings are those of the calling rank.
+         */
+        struct SolveReport
+        {
+            /** \brief Status returned by AmgX. */
+            AMGX_SOLVE_STATUS       status = AMGX_SOLVE_SUCCESS;
+
+            /** \brief Number of iterations used. */
+            int                     iters = 0;
+
+            /** \brief Residual norms from the initial one to the last one.
+             *
+             * AmgX only keeps the history when both `monitor_residual=1` and
+             * `store_res_history=1` are set in the configuration. Otherwise
+             * this vector is empty.
+             */
+            std::vector<double>     residuals;
+
+            /** \brief Time (s) spent gathering/scattering vectors. */
+            double                  scatterTime = 0.0;
+
+            /** \brief Time (s) spent uploading vectors to AmgX. */
+            double                  uploadTime = 0.0;
+
+            /** \brief Time (s) spent in AmgX solver. */
+            double                  solveTime = 0.0;
+
+            /** \brief Time (s) spent downloading the solution. */
+            double                  downloadTime = 0.0;
+
+            /** \brief Time (s) spent waiting for other ranks. */
+            double                  waitTime = 0.0;
+        };
+
+
+        /** \brief Statistics of the AMG hierarchy built by the last setup.
+         *
+         * AmgX reports the hierarchy only when the preconditioner's
+         * `print_grid_stats=1` is set in the configuration file. Otherwise,
+         * \ref HierarchyStats::nLevels "nLevels" is zero.
+         */
+        struct HierarchyStats
+        {
+            /** \brief Number of levels, including the finest one. */
+            int                     nLevels = 0;
+
+            /** \brief Number of rows on each level. */
+            std::vector<long long>  rows;
+
+            /** \brief Number of non-zeros on each level. */
+            std::vector<long long>  nnz;
+
+            /** \brief Estimated device memory (GB) of each level. */
+            std::vector<double>     memory;
+
+            /** \brief Sum of rows over all levels divided by fine rows. */
+            double                  gridComplexity = 0.0;
+
+            /** \brief Sum of non-zeros over all levels divided by fine ones. */
+            double                  operatorComplexity = 0.0;
+
+            /** \brief Estimated total device memory (GB) reported by AmgX. */
+            double                  totalMemory = 0.0;
+        };
+
+
         /** \brief Default constructor. */
         AmgXSolver() = default;
 
@@ -96,10 +186,13 @@ class AmgXSolver
          *
          * \param comm [in] MPI communicator.
          * \param modeStr [in] A string; target mode of AmgX (e.g., dDDI).
-         * \param cfgFile [in] A string; the path to AmgX configuration file.
+         * \param config [in] A string; the path to AmgX configuration file,
+         *      or see \p source.
+         * \param source [in] What \p config is.
          */
         AmgXSolver(const MPI_Comm &comm,
-                const std::string &modeStr, const std::string &cfgFile);
+                const std::string &modeStr, const std::string &config,
+                const ConfigSource source = ConfigSource::File);
 
 
         /** \brief Destructor. */
@@ -107,15 +200,24 @@ class AmgXSolver
 
 
         /** \brief Initialize a AmgXSolver instance.
+         *
+         * A configuration file is only read by the rank 0 of \p comm, which
+         * broadcasts it. With ConfigSource::String or ConfigSource::Options,
+         * no file is read at all, e.g., for parameter sweeps. AmgX itself
+         * and the AmgX objects of this instance are created by the first
+         * `setA` or `stageA`, unless `-amgx_prewarm` is given.
          *
          * \param comm [in] MPI communicator.
          * \param modeStr [in] A string; target mode of AmgX (e.g., dDDI).
-         * \param cfgFile [in] A string; the path to AmgX configuration file.
+         * \param config [in] A string; the path to AmgX configuration file,
+         *      or see \p source.
+         * \param source [in] What \p config is.
          *
          * \return PetscErrorCode.
          */
         PetscErrorCode initialize(const MPI_Comm &comm,
-                const std::string &modeStr, const std::string &cfgFile);
+                const std::string &modeStr, const std::string &config,
+                const ConfigSource source = ConfigSource::File);
 
 
         /** \brief Finalize this instance.
@@ -145,6 +247,30 @@ class AmgXSolver
         PetscErrorCode setA(const Mat &A);
 
 
+        /** \brief Set up separate operator and preconditioning matrices.
+         *
+         * As with `KSPSetOperators(ksp, A, P)`, the AMG hierarchy is built
+         * from \p P, e.g., a lower-order discretization or the matrix of a
+         * previous step, while the Krylov iterations apply \p A. With
+         * `-amgx_drop_tol <tol>`, off-diagonal entries of \p P smaller than
+         * `tol` times the largest magnitude in their row are dropped first.
+         *
+         * AmgX binds its Krylov solver and its AMG to one matrix. So when
+         * \p A and \p P differ, or entries are dropped, `solve` runs a PETSc
+         * Krylov solver (FGMRES by default, options prefix `-amgx_`) on \p A
+         * that applies one AmgX solve on \p P as its preconditioner. The
+         * AmgX configuration should then describe a cheap solve, e.g., a
+         * few AMG cycles. Only `solve` with PETSc Vecs is available.
+         *
+         * \param A [in] The operator, a PETSc Mat.
+         * \param P [in] The matrix to build the preconditioner from, an AIJ
+         *      Mat with the same parallel layout as \p A.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode setA(const Mat &A, const Mat &P);
+
+
         /** \brief Set up the matrix used by AmgX.
          *
          * This function sets up the AmgX matrix from the provided CSR data
@@ -188,6 +314,156 @@ class AmgXSolver
             const PetscScalar* values);
 
 
+        /** \brief Re-sets up an existing AmgX matrix with single-precision
+         *         values.
+         *
+         * Same as the other raw-array `updateA`, but the values stay in 32-bit
+         * through the consolidation and the upload. Requires a mode with a
+         * float matrix (dDFI, dFFI, hDFI, or hFFI).
+         *
+         * \param nLocalRows [in] The number of local rows on this rank.
+         * \param nLocalNz [in] The total number of non zero entries locally.
+         * \param values [in] The local CSR matrix values.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode updateA(
+            const PetscInt nLocalRows,
+            const PetscInt nLocalNz,
+            const float* values);
+
+
+        /** \brief Re-sets up the AmgX matrix from a PETSc Mat.
+         *
+         * The Mat must have the same non-zero pattern and parallel layout as
+         * the one given to the last `setA(const Mat &)`. Only the values are
+         * redistributed and uploaded, and AmgX re-uses the structure of the
+         * existing hierarchy, as in the other `updateA`.
+         *
+         * \param A [in] A PETSc Mat.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode updateA(const Mat &A);
+
+
+        /** \brief Re-sets up separate operator and preconditioning matrices.
+         *
+         * \p P must have the non-zero pattern of the one given to the last
+         * `setA(A, P)`; entries dropped there stay dropped. \p A may be a
+         * different Mat than before.
+         *
+         * \param A [in] The operator, a PETSc Mat.
+         * \param P [in] The matrix to build the preconditioner from.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode updateA(const Mat &A, const Mat &P);
+
+
+        /** \brief Set up a matrix in a spare slot while the current one
+         *      stays in use.
+         *
+         * The matrix is redistributed here, but its upload and the AMG setup
+         * run into a second AmgX matrix and solver. With
+         * `-amgx_stage_async` and an MPI library providing
+         * MPI_THREAD_MULTIPLE, they run on a helper thread, so `solve` with
+         * the current matrix overlaps with them; otherwise they run before
+         * this function returns. Nothing changes for `solve` or `updateA`
+         * until \ref AmgXSolver::swap "swap".
+         *
+         * \param A [in] A PETSc Mat, as for `setA(const Mat &)`. It must
+         *      stay alive and unchanged until `swap`.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode stageA(const Mat &A);
+
+
+        /** \brief Make the matrix given to `stageA` the current one.
+         *
+         * Waits for the staged setup to finish, then exchanges the slots.
+         * Afterwards, the instance is in the same state as after
+         * `setA(const Mat &)` with the staged matrix, and the previous
+         * matrix's slot is re-used by the next `stageA`.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode swap();
+
+
+        /** \brief Replace the AmgX configuration of this instance.
+         *
+         * Only the AmgX config and solver objects are re-created; the
+         * communicators, the resources, the consolidation buffers, and the
+         * uploaded matrix stay. If a matrix was set, the new solver is set up
+         * on it before this function returns, so `solve` can follow
+         * directly, e.g., after changing the tolerance.
+         *
+         * The new configuration must need as many halo rings as the old one
+         * while a matrix is set. It can not be called between `stageA` and
+         * `swap`.
+         *
+         * \param config [in] As in `initialize`.
+         * \param source [in] As in `initialize`.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode reconfigure(const std::string &config,
+                const ConfigSource source = ConfigSource::File);
+
+
+        /** \brief Change the tolerance of the following solves.
+         *
+         * AmgX reads the value when its solver is created, so the solver is
+         * created again and set up again with a resetup, which keeps the
+         * structure of the hierarchy; this can be called before solves,
+         * e.g., by an inexact Newton method. The value replaces `tolerance` of the outermost AmgX solver, whose
+         * meaning depends on its `convergence`; e.g., with
+         * `convergence=RELATIVE_INI_CORE` it is relative to the initial
+         * residual. After `setA(A, P)` with a separate P, it is the relative
+         * tolerance of the outer FGMRES instead, and AmgX keeps the
+         * tolerance of its configuration. It lasts until changed again
+         * or until `reconfigure`.
+         *
+         * \param tol [in] The new tolerance.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode setTolerance(const PetscReal tol);
+
+
+        /** \brief Change the maximum number of iterations of the following
+         *      solves.
+         *
+         * As \ref AmgXSolver::setTolerance "setTolerance", but for
+         * `max_iters`.
+         *
+         * \param maxIters [in] The new maximum number of iterations.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode setMaxIters(const PetscInt maxIters);
+
+
+        /** \brief Set the null space of the matrix, e.g., of an all-Neumann
+         *      problem.
+         *
+         * Solves with PETSc Vecs then remove the null space from a copy of
+         * the right-hand side before AmgX sees it, and from the solution
+         * afterwards, so a singular matrix needs no pinned row. \p ns is
+         * created as for `MatSetNullSpace`, e.g., with
+         * `MatNullSpaceCreate(comm, PETSC_TRUE, 0, nullptr, &ns)` for the
+         * constants. The instance keeps a reference, so the caller may
+         * destroy its own. A null \p ns removes the null space again.
+         *
+         * \param ns [in] The null space, or null.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode setNullSpace(const MatNullSpace &ns);
+
+
         /** \brief Solve the linear system.
          *
          * \p p vector will be used as an initial guess and will be updated to the
@@ -205,6 +481,21 @@ class AmgXSolver
         PetscErrorCode solve(Vec &p, Vec &b);
 
 
+        /** \brief Solve the linear system and report how it went.
+         *
+         * Same as \ref AmgXSolver::solve(Vec &, Vec &) "solve(p, b)", except
+         * that a solve that fails or diverges is not an error. Check
+         * \p report.status instead.
+         *
+         * \param p [in, out] A PETSc Vec object representing unknowns.
+         * \param b [in] A PETSc Vec representing right-hand-side.
+         * \param report [out] Outcome and timings of this solve.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve(Vec &p, Vec &b, SolveReport &report);
+
+
         /** \brief Solve the linear system.
          *
          * \p p vector will be used as an initial guess and will be updated to the
@@ -214,6 +505,8 @@ class AmgXSolver
          * function will do data gathering before solving and data scattering
          * after the solving.
          *
+         * The modes dFFI and hFFI take the float overload instead.
+         *
          * \param p [in, out] The unknown array.
          * \param b [in] The RHS array.
          * \param nRows [in] The number of rows in this rank.
@@ -223,6 +516,52 @@ class AmgXSolver
         PetscErrorCode solve(PetscScalar *p, const PetscScalar *b, const int nRows);
 
 
+        /** \brief Solve the linear system and report how it went.
+         *
+         * Same as the raw-array \ref AmgXSolver::solve "solve", except that a
+         * solve that fails or diverges is not an error. Check
+         * \p report.status instead.
+         *
+         * \param p [in, out] The unknown array.
+         * \param b [in] The RHS array.
+         * \param nRows [in] The number of rows in this rank.
+         * \param report [out] Outcome and timings of this solve.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve(PetscScalar *p, const PetscScalar *b,
+                const int nRows, SolveReport &report);
+
+
+        /** \brief Solve the linear system with single-precision arrays.
+         *
+         * Same as the raw-array \ref AmgXSolver::solve "solve", but the
+         * gathering, the upload, and the download stay in 32-bit. Requires a
+         * mode with float vectors (dFFI or hFFI).
+         *
+         * \param p [in, out] The unknown array.
+         * \param b [in] The RHS array.
+         * \param nRows [in] The number of rows in this rank.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve(float *p, const float *b, const int nRows);
+
+
+        /** \brief Solve the linear system with single-precision arrays and
+         *         report how it went.
+         *
+         * \param p [in, out] The unknown array.
+         * \param b [in] The RHS array.
+         * \param nRows [in] The number of rows in this rank.
+         * \param report [out] Outcome and timings of this solve.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve(float *p, const float *b,
+                const int nRows, SolveReport &report);
+
+
         /** \brief Get the number of iterations of the last solving.
          *
          * \param iter [out] Number of iterations.
@@ -242,19 +581,49 @@ class AmgXSolver
         PetscErrorCode getResidual(const int &iter, double &res);
 
 
+        /** \brief Get statistics of the AMG hierarchy.
+         *
+         * The statistics are those of the last `setA` or `updateA` and are
+         * the same on all ranks.
+         *
+         * \param stats [out] Statistics of the hierarchy.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode getHierarchyStats(HierarchyStats &stats);
+
+
     private:
 
         /** \brief Current count of AmgXSolver instances.
          *
-         * This static variable is used to count the number of instances. The
-         * fisrt instance is responsable for initializing AmgX library and the
-         * resource instance.
+         * This static variable is used to count the number of instances.
+         * Initializing the AmgX library is up to
+         * \ref AmgXSolver::amgxCount "amgxCount".
          */
         static int              count;
 
+        /** \brief Number of instances holding AmgX objects on this process.
+         *
+         * The first of them initializes the AmgX library, and the last one
+         * finalizes it.
+         */
+        static int              amgxCount;
+
         /** \brief A flag indicating if this instance has been initialized. */
         bool                    isInitialized = false;
 
+        /** \brief Whether AmgX has a matrix, set by `setA` or `swap`. */
+        bool                    hasA = false;
+
+        /** \brief Whether the AmgX objects of this instance exist; always
+         *         false outside \ref AmgXSolver::gpuWorld "gpuWorld". */
+        bool                    hasAmgX = false;
+
+        /** \brief The AmgX configuration, from
+         *         \ref AmgXSolver::getConfig "getConfig". */
+        std::string             cfgText;
+
         /** \brief The name of the node that this MPI process belongs to. */
         std::string             nodeName;
 
@@ -315,6 +684,16 @@ class AmgXSolver
         /** \brief AmgX solver mode. */
         AMGX_Mode               mode;
 
+        /** \brief Whether AmgX runs on the host (hDDI, hDFI, or hFFI). */
+        bool                    onHost = false;
+
+        /** \brief Whether AmgX vectors are float (dFFI or hFFI). */
+        bool                    floatVec = false;
+
+        /** \brief Whether the AmgX matrix is float (dDFI, dFFI, hDFI, or
+         *         hFFI). */
+        bool                    floatMat = false;
+
         /** \brief AmgX config object. */
         AMGX_config_handle      cfg = nullptr;
 
@@ -330,13 +709,49 @@ class AmgXSolver
         /** \brief AmgX solver object. */
         AMGX_solver_handle      solver = nullptr;
 
-        /** \brief AmgX resource object.
+        /** \brief AmgX resource object of this instance.
          *
-         * Due to the design of AmgX library, using more than one resource
-         * instance may cause some problems. So we make the resource instance
-         * as a static member to keep only one instance.
+         * Taken from \ref AmgXSolver::registry "registry", so it is shared
+         * with the other instances on the same processes and devices.
          */
-        static AMGX_resources_handle   rsrc;
+        AMGX_resources_handle   rsrc = nullptr;
+
+        /** \brief AmgX resources shared by instances with the same key. */
+        struct SharedRsrc
+        {
+            /** \brief Ranks in MPI_COMM_WORLD of the processes in gpuWorld;
+             *         part of the key. */
+            std::vector<int>        ranks;
+
+            /** \brief Device of this process; part of the key. */
+            int                     devID = -1;
+
+            /** \brief The same on all processes of the entry, so they agree
+             *         on which entry to share. */
+            int                     tag = 0;
+
+            /** \brief A duplicate of the gpuWorld of the first user, which
+             *         may be finalized before the others. */
+            MPI_Comm                comm = MPI_COMM_NULL;
+
+            /** \brief AmgX resource object. */
+            AMGX_resources_handle   rsrc = nullptr;
+
+            /** \brief Number of instances using it. */
+            int                     users = 1;
+
+            /** \brief Whether it belongs to one instance only; see
+             *         \ref AmgXSolver::threadSafe "threadSafe". */
+            bool                    exclusive = false;
+        };
+
+        /** \brief The resources of all instances on this process.
+         *
+         * Instances whose gpuWorld has the same processes and whose devices
+         * are the same share one entry. Instances on other sub-communicators
+         * or device sets get their own, so they can solve at the same time.
+         */
+        static std::vector<SharedRsrc>  registry;
 
         /** \brief Initialize consolidation, if required. Allocates space to hold
          * consolidated CSR matrix and solution/RHS vectors on the root rank and,
@@ -378,14 +793,16 @@ class AmgXSolver
 
         /** \brief Re-consolidates the values of the CSR matrix from multiple ranks.
          *
+         * \tparam T PetscScalar or float; instantiated in consolidate.cu.
          * \param nLocalNz [in] The number of non-zeros owned by this rank.
          * \param values [in] The values of the CSR matrix A.
          *
          * \return PetscErrorCode.
          */
+        template <typename T>
         PetscErrorCode reconsolidateValues(
             const PetscInt nLocalNz,
-            const PetscScalar *values);
+            const T *values);
 
         /** \brief De-allocates consolidated data structures, if any, after the AmgX matrix
          * has been constructed and the duplicate data becomes redundant.
@@ -455,6 +872,30 @@ class AmgXSolver
         /** \brief A temporary PETSc Vec holding redistributed RHS. */
         Vec                     redistRhs = nullptr;
 
+        /** \brief Rows owned by this process's devWorld, as computed by the
+         *         last `setA(const Mat &)`, or null after a `setA` with CSR
+         *         arrays. `updateA(const Mat &)` re-uses it. */
+        IS                      lastDevIS = nullptr;
+
+        /** \brief The drop tolerance applied by the last `setA`. */
+        PetscReal               dropTol = 0.0;
+
+        /** \brief Positions, in the local CSR data before dropping, of the
+         *         entries kept by the last `setA` with a drop tolerance. */
+        std::vector<PetscInt>   keptNz;
+
+        /** \brief A PETSc Krylov solver on the operator of `setA(A, P)`, or
+         *         the iterative refinement of `-amgx_refine`; null when AmgX
+         *         solves with its own Krylov solver. */
+        KSP                     outerKsp = nullptr;
+
+        /** \brief Whether `-amgx_refine` was given at `initialize`. */
+        PetscBool               refine = PETSC_FALSE;
+
+        /** \brief Whether \ref AmgXSolver::outerKsp "outerKsp" was created
+         *         as the Richardson iteration of `-amgx_refine`. */
+        PetscBool               outerRefine = PETSC_FALSE;
+
 
 
 
@@ -483,6 +924,20 @@ class AmgXSolver
 
 
         /** \brief Initialize all MPI communicators.
+         *
+         * The topology of \p comm comes from
+         * \ref AmgXSolver::getTopology "getTopology". This instance works on
+         * duplicates of its communicators, so messages of different instances
+         * never match each other.
+         *
+         * \param comm [in] Global communicator.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initMPIcomms(const MPI_Comm &comm);
+
+
+        /** \brief Work out the node, device, and gpuWorld topology of a
+         *      communicator into the members of this instance.
          *
          * The \p comm provided will be duplicated and saved to the
          * \ref AmgXSolver::globalCpuWorld "globalCpuWorld".
@@ -490,19 +945,184 @@ class AmgXSolver
          * \param comm [in] Global communicator.
          * \return PetscErrorCode.
          */
-        PetscErrorCode initMPIcomms(const MPI_Comm &comm);
+        PetscErrorCode splitComms(const MPI_Comm &comm);
+
+
+        /** \brief The topology of a communicator, shared by the instances
+         *      on it. */
+        struct Topology
+        {
+            MPI_Comm        globalCpuWorld;
+            MPI_Comm        localCpuWorld;
+            MPI_Comm        gpuWorld;
+            MPI_Comm        devWorld;
+            PetscMPIInt     globalSize;
+            PetscMPIInt     localSize;
+            PetscMPIInt     gpuWorldSize;
+            PetscMPIInt     devWorldSize;
+            PetscMPIInt     myGlobalRank;
+            PetscMPIInt     myLocalRank;
+            PetscMPIInt     myGpuWorldRank;
+            PetscMPIInt     myDevWorldRank;
+            PetscMPIInt     nDevs;
+            PetscMPIInt     devID;
+            PetscMPIInt     gpuProc;
+
+            /** \brief Instances using it, plus one while it is cached. */
+            int             users;
+        };
+
+        /** \brief The topology used by this instance. */
+        Topology                *topology = nullptr;
+
+        /** \brief MPI attribute keys of the cached topologies, for device
+         *         and host modes, which count devices differently. */
+        static int              topologyKeys[2];
+
+
+        /** \brief Get the topology of a communicator into the members of
+         *      this instance, working it out only if no instance did before.
+         *
+         * The topology is cached as an MPI attribute of \p comm, until
+         * \p comm is freed and no instance uses it.
+         *
+         * \param comm [in] Global communicator.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode getTopology(const MPI_Comm &comm);
+
+
+        /** \brief Stop using \ref AmgXSolver::topology "topology".
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode releaseTopology();
+
+
+        /** \brief Drop one user of a topology, freeing it after the last.
+         *
+         * Uses no PETSc, since MPI may call it through
+         * \ref AmgXSolver::deleteTopology "deleteTopology" after
+         * `PetscFinalize`.
+         *
+         * \param t [in] The topology.
+         * \return An MPI error code.
+         */
+        static int dropTopology(Topology *t);
+
+
+        /** \brief Called by MPI when a communicator with a cached topology
+         *      is freed. */
+        static int deleteTopology(MPI_Comm comm, int key, void *value,
+                void *extra);
 
 
         /** \brief Perform necessary initialization of AmgX.
          *
          * This function initializes AmgX for current instance. Based on
-         * \ref AmgXSolver::count "count", only the instance initialized first
-         * is in charge of initializing AmgX and the resource instance.
+         * \ref AmgXSolver::amgxCount "amgxCount", only the first instance
+         * creating AmgX objects is in charge of initializing AmgX. The
+         * resource instance comes from
+         * \ref AmgXSolver::acquireResources "acquireResources".
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initAmgX();
+
+
+        /** \brief Create the AmgX objects of this instance, if not yet done.
+         *
+         * `initialize` does not create them, so instances that never get a
+         * matrix cost nothing on the devices. The first `setA`, `stageA`, or
+         * `prewarm` calls this, collectively on
+         * \ref AmgXSolver::gpuWorld "gpuWorld".
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode startAmgX();
+
+
+        /** \brief Get the AmgX configuration as a string for
+         *      `AMGX_config_create`, the same on all processes.
+         *
+         * Collective over \ref AmgXSolver::globalCpuWorld "globalCpuWorld".
+         *
+         * \param config [in] As in `initialize`.
+         * \param source [in] As in `initialize`.
+         * \param cfgText [out] The configuration.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode getConfig(const std::string &config,
+                const ConfigSource source, std::string &cfgText);
+
+
+        /** \brief Scope of the outermost solver of a configuration, e.g.,
+         *      `main` for `solver(main)=FGMRES`, or `default`.
+         *
+         * \param cfgText [in] The configuration, from `getConfig`.
+         * \return The scope.
+         */
+        static std::string findScope(const std::string &cfgText);
+
+
+        /** \brief Hand the tolerance and the maximum number of iterations
+         *      set by the user to the solver that owns the solve: the outer
+         *      KSP if there is one, otherwise AmgX.
          *
-         * \param cfgFile [in] Path to AmgX solver configuration file.
          * \return PetscErrorCode.
          */
-        PetscErrorCode initAmgX(const std::string &cfgFile);
+        PetscErrorCode applyStopping();
+
+
+        /** \brief Create the AmgX solvers again if the stopping criteria
+         *      they should have changed.
+         *
+         * With an outer KSP, AmgX keeps those of its configuration;
+         * otherwise, it takes those set by the user. A staged matrix is set
+         * up again; the current one is left to the caller.
+         *
+         * \param outer [in] Whether an outer KSP owns the solve.
+         * \param changed [out] Whether the solvers were created again.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode stopAmgX(const bool outer, bool &changed);
+
+
+        /** \brief Scope of the outermost AmgX solver. */
+        std::string             solverScope = "default";
+
+        /** \brief Tolerance from `setTolerance`, or 0. */
+        PetscReal               userTol = 0.0;
+
+        /** \brief Maximum iterations from `setMaxIters`, or 0. */
+        PetscInt                userMaxIters = 0;
+
+        /** \brief Tolerance the AmgX solvers were created with, or 0 for
+         *         that of the configuration. */
+        PetscReal               amgxTol = 0.0;
+
+        /** \brief Maximum iterations the AmgX solvers were created with, or
+         *         0 for those of the configuration. */
+        PetscInt                amgxMaxIters = 0;
+
+
+        /** \brief Take the AmgX resources of this instance from
+         *      \ref AmgXSolver::registry "registry", creating them if no
+         *      entry has the same key on all processes of gpuWorld.
+         *
+         * Collective over \ref AmgXSolver::gpuWorld "gpuWorld".
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode acquireResources();
+
+
+        /** \brief Give the AmgX resources of this instance back, destroying
+         *      them if no other instance uses them.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode releaseResources();
 
 
         /** \brief Get IS for the row indices that processes in
@@ -560,17 +1180,80 @@ class AmgXSolver
                 std::vector<PetscInt64> &col, std::vector<PetscScalar> &data);
 
 
-        /** \brief Destroy the sequential local redistributed matrix.
+        /** \brief Drop small off-diagonal entries from local CSR data.
          *
-         * \param A [in] Original PETSc Mat.
-         * \param localA [in, out] Local matrix, returning null pointer.
+         * Also fills \ref AmgXSolver::keptNz "keptNz".
+         *
+         * \param devIS [in] PETSc IS representing redistributed row indices.
+         * \param tol [in] Entries below `tol` times the row maximum go.
+         * \param row [in, out] Row offsets.
+         * \param col [in, out] Global column indices.
+         * \param data [in, out] Values.
          * \return PetscErrorCode.
          */
-        PetscErrorCode destroyLocalA(const Mat &A, Mat &localA);
+        PetscErrorCode dropSmall(const IS &devIS, const PetscReal tol,
+                std::vector<PetscInt> &row, std::vector<PetscInt64> &col,
+                std::vector<PetscScalar> &data);
 
-        /** \brief Check whether the global matrix distribution is contiguous
+
+        /** \brief Upload a PETSc Mat to AmgX and set up the solver.
          *
-         * If the global matrix is distributed such that contiguous chunks of rows are
+         * \param A [in] The matrix.
+         * \param tol [in] Drop tolerance; 0 keeps all entries.
+         * \param outer [in] Whether an outer KSP will own the solves.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode setA_mat(const Mat &A, const PetscReal tol,
+                const bool outer);
+
+
+        /** \brief Whether the solves need
+         *      \ref AmgXSolver::outerKsp "outerKsp".
+         *
+         * \param A [in] The operator.
+         * \param P [in] The matrix given to AmgX.
+         * \param tol [in] Drop tolerance applied to \p P.
+         * \return Whether AmgX alone can not solve with \p A.
+         */
+        bool needsOuter(const Mat &A, const Mat &P, const PetscReal tol) const;
+
+
+        /** \brief Replace the values of the AmgX matrix with those of a Mat.
+         *
+         * \param A [in] The matrix.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode updateA_mat(const Mat &A);
+
+
+        /** \brief Read `-amgx_refine`.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initRefine();
+
+
+        /** \brief Create, update, or destroy
+         *      \ref AmgXSolver::outerKsp "outerKsp".
+         *
+         * \param A [in] The operator.
+         * \param P [in] The matrix given to AmgX.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode setOperator(const Mat &A, const Mat &P);
+
+
+        /** \brief Destroy the sequential local redistributed matrix.
+         *
+         * \param A [in] Original PETSc Mat.
+         * \param localA [in, out] Local matrix, returning null pointer.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode destroyLocalA(const Mat &A, Mat &localA);
+
+        /** \brief Check whether the global matrix distribution is contiguous
+         *
+         * If the global matrix is distributed such that contiguous chunks of rows are
          * distributed over the individual ranks in ascending rank order, the partition vector
          * has trivial structure (i.e. [0, ..., 0, 1, ..., 1, ..., R-1, ..., R-1] for R ranks) and
          * its calculation can be skipped since all information is available to AmgX through
@@ -607,7 +1290,1006 @@ class AmgXSolver
          *
          * \param p [in, out] PETSc Vec for unknowns.
          * \param b [in] PETSc Vec for RHS.
+         * \param report [out] If not null, failures are recorded here
+         *      instead of raising an error.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve_real(Vec &p, Vec &b, SolveReport *report);
+
+
+        /** \brief Solve with PETSc Vecs, doing data gathering/scattering.
+         *
+         * \param p [in, out] PETSc Vec for unknowns.
+         * \param b [in] PETSc Vec for RHS.
+         * \param report [out] Optional report; may be null.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve_vec(Vec &p, Vec &b, SolveReport *report);
+
+
+        /** \brief Solve with AmgX, gathering/scattering PETSc Vecs.
+         *
+         * \param p [in, out] PETSc Vec for unknowns.
+         * \param b [in] PETSc Vec for RHS.
+         * \param report [out] Optional report; may be null.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve_dist(Vec &p, Vec &b, SolveReport *report);
+
+
+        /** \brief Solve with \ref AmgXSolver::outerKsp "outerKsp".
+         *
+         * \param p [in, out] PETSc Vec for unknowns.
+         * \param b [in] PETSc Vec for RHS.
+         * \param report [out] Optional report; may be null.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve_outer(Vec &p, Vec &b, SolveReport *report);
+
+
+        /** \brief The PCSHELL apply of \ref AmgXSolver::outerKsp "outerKsp".
+         *
+         * \param pc [in] The PC; its context is the AmgXSolver.
+         * \param x [in] The vector to precondition.
+         * \param y [out] One AmgX solve on P applied to \p x.
+         * \return PetscErrorCode.
+         */
+        static PetscErrorCode applyOuterPC(PC pc, Vec x, Vec y);
+
+
+        /** \brief Solve with raw arrays, doing consolidation if required.
+         *
+         * \param p [in, out] The unknown array.
+         * \param b [in] The RHS array.
+         * \param nRows [in] The number of rows in this rank.
+         * \tparam T PetscScalar or float.
+         * \param report [out] Optional report; may be null.
+         * \return PetscErrorCode.
+         */
+        template <typename T>
+        PetscErrorCode solve_raw(T *p, const T *b,
+                const int nRows, SolveReport *report);
+
+
+        /** \brief Re-sets up the AmgX matrix with raw values.
+         *
+         * \tparam T PetscScalar or float.
+         * \param nLocalRows [in] The number of local rows on this rank.
+         * \param nLocalNz [in] The total number of non zero entries locally.
+         * \param values [in] The local CSR matrix values.
+         * \return PetscErrorCode.
+         */
+        template <typename T>
+        PetscErrorCode updateA_raw(const PetscInt nLocalRows,
+                const PetscInt nLocalNz, const T *values);
+
+
+        /** \brief Check the status of the last solve on ranks in
+         *      \ref AmgXSolver::gpuWorld "gpuWorld".
+         *
+         * Without \p report, a failed solve is an error. Otherwise, the
+         * status, number of iterations and residual history are stored.
+         *
+         * \param report [out] Optional report; may be null.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode checkStatus(SolveReport *report);
+
+
+        /** \brief Share the outcome of the last solve with all ranks and
+         *      store the timings of this rank.
+         *
+         * \param report [in, out] The report; nothing is done if null.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode finishReport(SolveReport *report);
+
+
+
+
+        /** \brief Internal phases of the wrapper logged as PETSc events. */
+        enum Event
+        {
+            EvGetDevIS = 0,
+            EvRedistMat,
+            EvGetRawData,
+            EvGetPartData,
+            EvConsolidate,
+            EvUploadA,
+            EvSetup,
+            EvResetup,
+            EvVecScatter,
+            EvVecUpload,
+            EvSolve,
+            EvVecDownload,
+            EvMPIWait,
+            nEvents
+        };
+
+        /** \brief Names of the events, used by both PETSc and the trace. */
+        static const char      *eventNames[nEvents];
+
+        /** \brief PETSc class ID that all wrapper events belong to. */
+        static PetscClassId     classId;
+
+        /** \brief PETSc log events of the phases listed in \ref Event. */
+        static PetscLogEvent    events[nEvents];
+
+        /** \brief A flag indicating if the events have been registered. */
+        static PetscBool        eventsRegistered;
+
+
+        /** \brief Register the PETSc class and log events of the wrapper.
+         *
+         * Only the first call after PetscInitialize does the registration.
+         * The flag is reset at PetscFinalize, so that a new PETSc session
+         * registers the events again.
+         *
+         * \return PetscErrorCode.
+         */
+        static PetscErrorCode registerEvents();
+
+
+        /** \brief Reset \ref AmgXSolver::eventsRegistered "eventsRegistered"
+         *      at PetscFinalize.
+         *
+         * \return PetscErrorCode.
+         */
+        static PetscErrorCode unregisterEvents();
+
+
+        /** \brief Begin logging an internal phase.
+         *
+         * \param e [in] The phase.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode eventBegin(const Event e);
+
+
+        /** \brief End logging an internal phase.
+         *
+         * \param e [in] The phase.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode eventEnd(const Event e);
+
+
+        /** \brief Log bytes copied from host to device.
+         *
+         * Nothing is logged if \p ptr already lives on the device or if PETSc
+         * is not configured with CUDA.
+         *
+         * \param ptr [in] Source pointer of the copy.
+         * \param bytes [in] Number of bytes.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode logCpuToGpu(const void *ptr, const PetscLogDouble bytes);
+
+
+        /** \brief Log bytes copied from device to host.
+         *
+         * Nothing is logged if \p ptr lives on the device or if PETSc is not
+         * configured with CUDA.
+         *
+         * \param ptr [in] Destination pointer of the copy.
+         * \param bytes [in] Number of bytes.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode logGpuToCpu(const void *ptr, const PetscLogDouble bytes);
+
+
+        /** \brief Check whether a pointer refers to device memory.
+         *
+         * \param ptr [in] The pointer.
+         * \return A bool.
+         */
+        static bool isDevicePtr(const void *ptr);
+
+
+        /** \brief The MPI datatype of an array of raw values.
+         *
+         * \return MPI_DOUBLE or MPI_FLOAT.
+         */
+        static MPI_Datatype mpiType(const double *);
+
+        /** \copydoc AmgXSolver::mpiType(const double *) */
+        static MPI_Datatype mpiType(const float *);
+
+
+        /** \brief Copy PetscScalar values, on the host or on the device,
+         *         into float on the host.
+         *
+         * \param src [in] The values.
+         * \param n [in] Their number.
+         * \param dst [out] The narrowed values.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode narrow(const PetscScalar *src, const PetscInt n,
+                std::vector<float> &dst);
+
+
+        /** \brief Matrix values in the precision AmgX reads them in.
+         *
+         * AmgX reads matrix values as float in dDFI, dFFI, hDFI, and hFFI,
+         * so PetscScalar values are then narrowed into \p buffer.
+         *
+         * \param values [in] The values, on the host or on the device.
+         * \param n [in] Their number.
+         * \param buffer [out] Holds the narrowed values, if any.
+         * \param data [out] \p values, or the data of \p buffer.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode matValues(const PetscScalar *values, const PetscInt n,
+                std::vector<float> &buffer, const void *&data);
+
+        /** \copydoc AmgXSolver::matValues(const PetscScalar *, const PetscInt, std::vector<float> &, const void *&) */
+        PetscErrorCode matValues(const float *values, const PetscInt n,
+                std::vector<float> &buffer, const void *&data);
+
+
+        /** \brief Bytes of one matrix value in AmgX.
+         *
+         * \return sizeof(float) or sizeof(PetscScalar).
+         */
+        size_t matBytes() const;
+
+
+        /** \brief MPI_Barrier logged as \ref AmgXSolver::EvMPIWait "EvMPIWait".
+         *
+         * \param comm [in] The communicator to synchronize.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode barrier(const MPI_Comm &comm);
+
+
+        /** \brief MPI_Waitall logged as \ref AmgXSolver::EvMPIWait "EvMPIWait".
+         *
+         * \param n [in] Number of requests.
+         * \param req [in, out] The requests.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode waitAll(const int n, MPI_Request *req);
+
+
+
+
+        /** \brief A finished phase in the timeline trace. */
+        struct TraceRecord
+        {
+            /** \brief The phase, an index in \ref AmgXSolver::Event "Event". */
+            int         event;
+
+            /** \brief Begin time (s) relative to the trace origin. */
+            double      begin;
+
+            /** \brief End time (s) relative to the trace origin. */
+            double      end;
+        };
+
+        /** \brief Number of instances ever initialized in this process. */
+        static int              serialCount;
+
+        /** \brief Initialization order of this instance; 0 for the first one. */
+        int                     serial = 0;
+
+        /** \brief A flag indicating if the timeline trace is recorded. */
+        PetscBool               traceEnabled = PETSC_FALSE;
+
+        /** \brief Path to the Chrome trace file written at finalization. */
+        std::string             traceFile;
+
+        /** \brief MPI_Wtime at which the trace starts. */
+        double                  traceOrigin = 0.0;
+
+        /** \brief Begin time of the phases currently open. */
+        double                  phaseBegin[nEvents] = {};
+
+        /** \brief Accumulated time (s) of each phase since the last reset. */
+        double                  phaseTime[nEvents] = {};
+
+        /** \brief Ring buffer of finished phases on this rank. */
+        std::vector<TraceRecord>    traceBuffer;
+
+        /** \brief Number of phases recorded so far, including overwritten ones. */
+        size_t                  traceNext = 0;
+
+        /** \brief Accumulated MPI wait time (s) of this rank. */
+        double                  traceWait = 0.0;
+
+
+        /** \brief Set up the timeline trace if requested through options.
+         *
+         * The trace is enabled by `-amgx_trace <file>`. `-amgx_trace_size <n>`
+         * sets the number of phases kept per rank (default 16384); older
+         * phases are overwritten once the ring buffer is full.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initTrace();
+
+
+        /** \brief Write the merged trace of all ranks in Chrome trace format.
+         *
+         * The rank 0 of \ref AmgXSolver::globalCpuWorld "globalCpuWorld"
+         * receives the records of other ranks one at a time and writes them,
+         * so its memory usage does not grow with the number of ranks.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode writeTrace();
+
+
+
+        /** \brief Give a file name that is unique to this instance.
+         *
+         * The first instance uses \p file as is. Later instances insert their
+         * serial number before the `.json` extension, or append it if there
+         * is no such extension.
+         *
+         * \param file [in] The file name requested by the user.
+         * \return The file name for this instance.
+         */
+        std::string serialFileName(const std::string &file) const;
+
+
+
+
+        /** \brief Quantities kept in the job-wide statistics. */
+        enum Stat
+        {
+            StSetup = 0,
+            StResetup,
+            StSolve,
+            StIters,
+            nStats
+        };
+
+        /** \brief Names of the statistics, used as keys in the output. */
+        static const char      *statNames[nStats];
+
+        /** \brief A fixed-size histogram with running summaries.
+         *
+         * Times use logarithmic bins, 16 per decade from 1 us to 100 s.
+         * Iterations use bins of width one. Values out of range go to the
+         * first or the last bin; the exact extremes are kept separately.
+         */
+        struct Histogram
+        {
+            /** \brief Number of bins. */
+            static const int    nBins = 128;
+
+            /** \brief Number of samples. */
+            long long           count = 0;
+
+            /** \brief Sum of samples. */
+            double              sum = 0.0;
+
+            /** \brief Smallest sample. */
+            double              min = std::numeric_limits<double>::max();
+
+            /** \brief Largest sample. */
+            double              max = std::numeric_limits<double>::lowest();
+
+            /** \brief Number of samples in each bin. */
+            long long           bins[nBins] = {};
+        };
+
+        /** \brief Statistics of this instance on this rank. */
+        Histogram               stats[nStats];
+
+
+        /** \brief The bin a sample falls into.
+         *
+         * \param s [in] The quantity.
+         * \param value [in] The sample.
+         * \return Index of the bin.
+         */
+        static int statBin(const Stat s, const double value);
+
+
+        /** \brief A representative value of a bin.
+         *
+         * \param s [in] The quantity.
+         * \param b [in] Index of the bin.
+         * \return The geometric (times) or arithmetic (iterations) center.
+         */
+        static double binValue(const Stat s, const int b);
+
+
+        /** \brief Add a sample to the statistics.
+         *
+         * \param s [in] The quantity.
+         * \param value [in] The sample.
+         */
+        void addSample(const Stat s, const double value);
+
+
+        /** \brief Record the wall time and iterations of a solve.
+         *
+         * Times are sampled on every rank. Iterations are only sampled on
+         * rank 0 so that they are counted once per solve.
+         *
+         * \param time [in] Wall time (s) of the solve on this rank.
+         * \param iters [in] Iterations of the solver that owned the solve:
+         *      the host KSP, the outer KSP, or AmgX.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordSolve(const double time, const PetscInt iters);
+
+
+        /** \brief Reduce the statistics across
+         *      \ref AmgXSolver::globalCpuWorld "globalCpuWorld" and write them.
+         *
+         * Nothing is written unless `-amgx_stats <file>` is given. The
+         * statistics are reset afterwards.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode writeStats();
+
+
+
+        /** \brief Buffer receiving AmgX output, if not null.
+         *
+         * AmgX's print callback takes no user data, so the instance running
+         * a setup points this to its own buffer during the call. It is per
+         * thread, since staged setups may run on a helper thread.
+         */
+        static thread_local std::string    *printCapture;
+
+        /** \brief Whether AmgX output is dropped, e.g., during `prewarm`. */
+        static thread_local bool            printMuted;
+
+        /** \brief Statistics of the current AMG hierarchy. */
+        HierarchyStats          hierarchy;
+
+
+        /** \brief Set up or re-set up the AmgX solver, capturing its output.
+         *
+         * \param resetup [in] Whether to call AMGX_solver_resetup.
+         * \param log [out] What AmgX printed during the setup.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode setupSolver(const bool resetup, std::string &log);
+
+
+        /** \brief Parse the grid statistics printed by AmgX.
+         *
+         * Called on all ranks of \ref AmgXSolver::globalCpuWorld
+         * "globalCpuWorld". The output on rank 0 is parsed and the result is
+         * broadcast. \ref AmgXSolver::hierarchy "hierarchy" is only replaced
+         * if the output contains grid statistics.
+         *
+         * \param log [in] What AmgX printed during the last setup.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode parseGridStats(const std::string &log);
+
+
+
+
+        /** \brief The record file of this rank, or null if not recording. */
+        FILE                   *recordFp = nullptr;
+
+        /** \brief MPI_Wtime at which the record starts. */
+        double                  recordOrigin = 0.0;
+
+        /** \brief The matrix values of the last recorded call.
+         *
+         * `updateA` only records the values that differ from these.
+         */
+        std::vector<PetscScalar>    recordValues;
+
+        /** \brief The initial guess of the solve being recorded. */
+        std::vector<PetscScalar>    recordGuess;
+
+
+        /** \brief AmgX handles and PETSc objects of one matrix. */
+        struct Slot
+        {
+            /** \brief AmgX matrix object. */
+            AMGX_matrix_handle      A = nullptr;
+
+            /** \brief AmgX vector object representing unknowns. */
+            AMGX_vector_handle      P = nullptr;
+
+            /** \brief AmgX vector object representing RHS. */
+            AMGX_vector_handle      RHS = nullptr;
+
+            /** \brief AmgX solver object. */
+            AMGX_solver_handle      solver = nullptr;
+
+            /** \brief Index in \ref AmgXSolver::stageRsrc "stageRsrc" of the
+             *         resources of the handles, or -1 for \ref AmgXSolver::rsrc "rsrc". */
+            int                     rsrcId = -1;
+
+            /** \brief As \ref AmgXSolver::lastDevIS "lastDevIS". */
+            IS                      devIS = nullptr;
+
+            /** \brief As \ref AmgXSolver::scatterLhs "scatterLhs". */
+            VecScatter              scatterLhs = nullptr;
+
+            /** \brief As \ref AmgXSolver::scatterRhs "scatterRhs". */
+            VecScatter              scatterRhs = nullptr;
+
+            /** \brief As \ref AmgXSolver::redistLhs "redistLhs". */
+            Vec                     redistLhs = nullptr;
+
+            /** \brief As \ref AmgXSolver::redistRhs "redistRhs". */
+            Vec                     redistRhs = nullptr;
+
+            /** \brief The staged Mat, referenced until `swap`. */
+            Mat                     mat = nullptr;
+
+            /** \brief Whether a matrix waits here for `swap`. */
+            bool                    staged = false;
+
+            /** \brief AmgX output of the staged setup. */
+            std::string             gridStats;
+
+            /** \brief Wall time (s) of the staged setup. */
+            double                  setupTime = 0.0;
+        };
+
+        /** \brief CSR data handed to a staged setup. */
+        struct StageJob
+        {
+            AMGX_matrix_handle          A;
+            AMGX_vector_handle          P;
+            AMGX_vector_handle          RHS;
+            AMGX_solver_handle          solver;
+            AMGX_config_handle          cfg;
+            int                         devID;
+            bool                        onHost;
+            PetscInt                    nGlobalRows;
+            PetscInt                    nLocalRows;
+            PetscBool                   usesOffsets;
+            std::vector<PetscInt>       row;
+            std::vector<PetscInt64>     col;
+            std::vector<PetscScalar>    data;
+            std::vector<PetscInt>       partData;
+            bool                        floatMat;
+        };
+
+        /** \brief The slot `stageA` sets up; the current one is in the
+         *         members AmgXA, solver, lastDevIS, and so on. */
+        Slot                    spare;
+
+        /** \brief Resources index of the current slot, as Slot::rsrcId. */
+        int                     activeRsrc = -1;
+
+        /** \brief Resources of this instance used by staged setups.
+         *
+         * A setup on a helper thread must not share resources, nor their
+         * communicator, with the solves of the current slot. The two slots
+         * end up alternating between these two.
+         */
+        AMGX_resources_handle   stageRsrc[2] = {nullptr, nullptr};
+
+        /** \brief Duplicates of gpuWorld used by \ref AmgXSolver::stageRsrc
+         *         "stageRsrc". */
+        MPI_Comm                stageComm[2] = {MPI_COMM_NULL, MPI_COMM_NULL};
+
+        /** \brief The helper thread of an asynchronous staged setup. */
+        std::thread             stageThread;
+
+        /** \brief Whether staged setups run on a helper thread. */
+        bool                    stageAsync = false;
+
+
+        /** \brief Read `-amgx_stage_async` and check MPI's thread support.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initStage();
+
+
+        /** \brief Wait for a staged setup to finish.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode waitStage();
+
+
+        /** \brief Give the spare slot AmgX handles on resources the current
+         *      slot does not use.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode prepareSpare();
+
+
+        /** \brief Exchange the current slot with the spare one. */
+        void swapSlot();
+
+
+        /** \brief Redistribute a staged matrix with PETSc into the current
+         *      slot, which `stageA` has exchanged with the spare one.
+         *
+         * \param A [in] The matrix.
+         * \param job [out] The CSR data for the upload.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode stageLocal(const Mat &A, StageJob &job);
+
+
+        /** \brief Destroy the spare slot and the staging resources.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode finalizeStage();
+
+
+        /** \brief Upload CSR data and set up AmgX, without PETSc calls.
+         *
+         * Safe to run on a helper thread.
+         *
+         * \param job [in] The data and the handles to use.
+         * \param log [out] AmgX output during the setup.
+         * \param time [in, out] Wall time (s) of the setup is added here.
+         */
+        static void runStage(StageJob job, std::string *log, double *time);
+
+
+        /** \brief CUDA stream of the copies made by this instance, e.g.,
+         *         those of consolidation; null until a call with raw arrays
+         *         needs it, and in host modes. */
+        cudaStream_t            stream = nullptr;
+
+        /** \brief Whether `-amgx_thread_safe` was given.
+         *
+         * Then this instance never shares its AmgX resources, so its setups
+         * and solves can run at the same time as those of other instances
+         * called from other threads.
+         */
+        bool                    threadSafe = false;
+
+        /** \brief The thread that registered the PETSc log events.
+         *
+         * PETSc logging is not thread-safe, so events and traffic are only
+         * logged to PETSc from this thread. Timings of the wrapper itself,
+         * e.g., reports, traces, and statistics, are kept on every thread.
+         */
+        static std::thread::id  logThread;
+
+
+        /** \brief Read `-amgx_thread_safe`.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initThreads();
+
+
+        /** \brief Make the device of this process current on the calling
+         *      thread.
+         *
+         * Processes outside \ref AmgXSolver::gpuWorld "gpuWorld" are left
+         * alone until they pass device arrays, so they never create a CUDA
+         * context of their own otherwise.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode bindDevice();
+
+
+        /** \brief Create \ref AmgXSolver::stream "stream", if not yet done.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode useStream();
+
+
+        /** \brief Destroy the stream of this instance.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode finalizeThreads();
+
+
+        /** \brief Whether the calling thread is \ref AmgXSolver::logThread
+         *      "logThread". */
+        static bool onLogThread();
+
+
+        /** \brief Run a dummy setup and solve if `-amgx_prewarm <rows>` is
+         *      given.
+         *
+         * The first setup and solve of a process pay for the CUDA context,
+         * the handles of the libraries AmgX uses, and the first allocations
+         * of its memory pools. This moves that cost into `initialize`. The
+         * dummy system is a 1D Poisson problem with `<rows>` rows per process
+         * of \ref AmgXSolver::globalCpuWorld "globalCpuWorld", so the vectors
+         * and the pools are sized as for the real one. It is set up with the
+         * handles and the configuration of this instance, and `setA`
+         * replaces it.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode prewarm();
+
+
+        /** \brief Iterations over the post-setup baseline that trigger a
+         *         rebuild; 0 disables this criterion. */
+        PetscReal               reuseRatio = 0.0;
+
+        /** \brief Iterations that trigger a rebuild; 0 disables this
+         *         criterion. */
+        PetscInt                reuseMaxIters = 0;
+
+        /** \brief Iterations of the first solve after the last full setup,
+         *         or -1 before that solve. */
+        PetscInt                reuseBaseline = -1;
+
+        /** \brief Whether `updateA` changed values since the last setup or
+         *         resetup of the hierarchy. */
+        bool                    reuseStale = false;
+
+
+        /** \brief Read the reuse policy from options.
+         *
+         * With `-amgx_reuse_ratio <r>` or `-amgx_reuse_max_iters <n>`,
+         * `updateA` only replaces the values of the fine level and keeps the
+         * rest of the hierarchy. After each solve, if the iterations exceed
+         * `r` times those of the first solve after the last full setup, or
+         * exceed `n`, the hierarchy is rebuilt for the next solve: with a
+         * resetup if values changed since the last (re)setup, otherwise with
+         * a full setup. Without these options, `updateA` always resets up.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initReuse();
+
+
+        /** \brief Forget the baseline after a full setup.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode resetReuse();
+
+
+        /** \brief Whether `updateA` should skip the resetup.
+         *
+         * \return True if the reuse policy is enabled.
+         */
+        bool keepHierarchy();
+
+
+        /** \brief Rebuild the hierarchy if the last solve took too many
+         *      iterations.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode checkReuse();
+
+
+        /** \brief Start recording calls if requested through options.
+         *
+         * Recording is enabled by `-amgx_record <file>`. Every rank writes
+         * to `<file>.<rank>`; see AmgXRecord.hpp for the layout.
+         *
+         * \param modeStr [in] The mode given to `initialize`.
+         * \param cfgFile [in] The configuration file given to `initialize`.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initRecord(
+                const std::string &modeStr, const std::string &cfgFile);
+
+
+        /** \brief Close the record file, if any.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode closeRecord();
+
+
+        /** \brief Write the header of a recorded call.
+         *
+         * \param kind [in] An AmgXRecord::Kind.
+         * \param onDevice [in] Whether the arrays of the call are on the device.
+         * \param begin [in] MPI_Wtime at which the call started.
+         * \param end [in] MPI_Wtime at which the call returned.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordEntry(const int kind, const bool onDevice,
+                const double begin, const double end);
+
+
+        /** \brief Write an array to the record file.
+         *
+         * Device memory is copied to the host first.
+         *
+         * \param ptr [in] The array, on the host or on the device.
+         * \param bytes [in] Size of the array.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordData(const void *ptr, const size_t bytes);
+
+
+        /** \brief Record a call to `setA` with a PETSc Mat.
+         *
+         * \param A [in] The matrix.
+         * \param begin [in] MPI_Wtime at which the call started.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordSetA(const Mat &A, const double begin);
+
+
+        /** \brief Record a call to `setA` with CSR arrays.
+         *
+         * The parameters other than \p begin are those of the call.
+         *
+         * \param begin [in] MPI_Wtime at which the call started.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordSetA(const PetscInt nGlobalRows,
+                const PetscInt nLocalRows, const PetscInt nLocalNz,
+                const PetscInt *rowOffsets, const PetscInt *colIndicesGlobal,
+                const PetscScalar *values, const PetscInt *partData,
+                const double begin);
+
+
+        /** \brief Record a call to `updateA`.
+         *
+         * The parameters other than \p begin are those of the call.
+         *
+         * \param begin [in] MPI_Wtime at which the call started.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordUpdateA(const PetscInt nLocalRows,
+                const PetscInt nLocalNz, const PetscScalar *values,
+                const double begin);
+
+
+        /** \brief Record a call to the single-precision `updateA`.
+         *
+         * Written as AmgXRecord::UpdateAFloat, with the values widened to
+         * PetscScalar.
+         */
+        PetscErrorCode recordUpdateA(const PetscInt nLocalRows,
+                const PetscInt nLocalNz, const float *values,
+                const double begin);
+
+
+        /** \brief Record a call to `updateA` with a PETSc Mat.
+         *
+         * \param A [in] The matrix.
+         * \param begin [in] MPI_Wtime at which the call started.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordUpdateA(const Mat &A, const double begin);
+
+
+        /** \brief Write new matrix values, as a delta if that is smaller.
+         *
+         * \param kind [in] AmgXRecord::UpdateA, AmgXRecord::UpdateAMat, or
+         *      AmgXRecord::UpdateAFloat.
+         * \param onDevice [in] Whether the values of the call were on the device.
+         * \param nLocalRows [in] The number of local rows.
+         * \param current [in, out] The new values; swapped into
+         *      \ref AmgXSolver::recordValues "recordValues".
+         * \param begin [in] MPI_Wtime at which the call started.
+         * \param end [in] MPI_Wtime at which the call ended.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordDelta(const int kind, const bool onDevice,
+                const PetscInt nLocalRows, std::vector<PetscScalar> &current,
+                const double begin, const double end);
+
+
+        /** \brief Keep the initial guess before a solve overwrites it.
+         *
+         * \param p [in] The initial guess, on the host or on the device.
+         * \param nRows [in] Its length.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode keepGuess(const PetscScalar *p, const int nRows);
+
+        /** \copydoc AmgXSolver::keepGuess(const PetscScalar *, const int) */
+        PetscErrorCode keepGuess(const float *p, const int nRows);
+
+
+        /** \brief Record a call to `solve`.
+         *
+         * \param kind [in] AmgXRecord::SolveVec or AmgXRecord::SolveRaw.
+         * \param b [in] The right-hand side, on the host or on the device.
+         * \param nRows [in] Its length.
+         * \param begin [in] MPI_Wtime at which the call started.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordSolveCall(const int kind, const PetscScalar *b,
+                const int nRows, const double begin);
+
+
+        /** \brief Record a call to the single-precision `solve`.
+         *
+         * \param kind [in] AmgXRecord::SolveRawFloat.
+         * \param b [in] The right-hand side, on the host or on the device.
+         * \param nRows [in] Its length.
+         * \param begin [in] MPI_Wtime at which the call started.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode recordSolveCall(const int kind, const float *b,
+                const int nRows, const double begin);
+
+
+        /** \brief Copy single-precision values, on the host or on the device,
+         *         into PetscScalar for a record.
+         *
+         * \param src [in] The values.
+         * \param n [in] Their number.
+         * \param dst [out] The widened values.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode widen(const float *src, const PetscInt n,
+                std::vector<PetscScalar> &dst);
+
+
+        /** \brief Global rows at or below which `setA` solves on the host;
+         *         0 disables the host path. */
+        PetscInt                hostRows = 0;
+
+        /** \brief Global nonzeros at or below which `setA` solves on the
+         *         host; 0 means no limit. */
+        PetscInt                hostNnz = 0;
+
+        /** \brief A PETSc direct solver on a redundant copy of the matrix,
+         *         or null when AmgX solves. */
+        KSP                     hostKsp = nullptr;
+
+
+        /** \brief Read `-amgx_host_rows` and `-amgx_host_nnz`.
+         *
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode initHost();
+
+
+        /** \brief Factorize a small matrix on the host instead of giving it
+         *      to AmgX.
+         *
+         * Every process gathers the whole matrix and factorizes it with
+         * PETSc, through PCREDUNDANT and the options prefix `amgx_host_`. The
+         * devices and AmgX are not touched at all.
+         *
+         * \param A [in] The matrix.
+         * \param done [out] Whether \p A was small enough.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode setHost(const Mat &A, bool &done);
+
+
+        /** \brief Factorize the new values of a matrix solved on the host.
+         *
+         * \param A [in] The matrix.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode updateHost(const Mat &A);
+
+
+        /** \brief Solve with \ref AmgXSolver::hostKsp "hostKsp".
+         *
+         * \param p [in, out] The unknown vector.
+         * \param b [in] The right-hand side.
+         * \param report [out] Outcome of the solve, if not null.
+         * \return PetscErrorCode.
+         */
+        PetscErrorCode solve_host(Vec &p, Vec &b, SolveReport *report);
+
+
+        /** \brief The null space from `setNullSpace`, or null. */
+        MatNullSpace            nullSpace = nullptr;
+
+        /** \brief The right-hand side with the null space removed. */
+        Vec                     nullRhs = nullptr;
+
+
+        /** \brief Remove \ref AmgXSolver::nullSpace "nullSpace" from a copy
+         *      of the right-hand side.
+         *
+         * \param b [in] The right-hand side.
+         * \param rhs [out] \ref AmgXSolver::nullRhs "nullRhs", which holds
+         *      the projected copy.
          * \return PetscErrorCode.
          */
-        PetscErrorCode solve_real(Vec &p, Vec &b);
+        PetscErrorCode projectRhs(const Vec &b, Vec &rhs);
 };
@@ -0,0 +1,40 @@
+/**
+ * \file PCAMGX.hpp
+ * \brief AmgX as a PETSc preconditioner type.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ *
+ * Once registered, any KSP can use AmgX through `-pc_type amgx` or
+ * `PCSetType(pc, PCAMGX)`. Each application of the preconditioner runs a
+ * single solve of AmgX from a zero initial guess, so the AmgX configuration
+ * should only describe the preconditioner, e.g., `solver=AMG` with
+ * `max_iters=1`. Options, all read at the first `PCSetUp`, are
+ *
+ * - `-pc_amgx_config <file>`: the AmgX configuration file (required);
+ * - `-pc_amgx_mode <mode>`: the AmgX mode (default: dDDI).
+ *
+ * The first `PCSetUp` calls AmgXSolver::setA. Later ones call
+ * AmgXSolver::updateA when PETSc reports the same non-zero pattern, which
+ * re-uses the redistribution of rows, the scatters of vectors, and the
+ * structure of the AMG hierarchy, and call AmgXSolver::setA otherwise.
+ */
+
+
+# pragma once
+
+// PETSc
+# include <petscpc.h>
+
+
+/** \brief The name of AmgX as a PCType. */
+# define PCAMGX "amgx"
+
+
+/** \brief Register \ref PCAMGX "PCAMGX" with PETSc.
+ *
+ * Call it once after `PetscInitialize` and before `KSPSetFromOptions`.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode PCAmgXRegister();
@@ -0,0 +1,434 @@
+/**
+ * \file config.cpp
+ * \brief Definition of member functions regarding AmgX configurations.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <algorithm>
+# include <cctype>
+# include <fstream>
+# include <iomanip>
+# include <sstream>
+# include <utility>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+namespace
+{
+
+/** \brief Turn the content of a configuration file into a string for
+ *      `AMGX_config_create`: one `name=value` per line, comments after `#`. */
+std::string fileToParameters(const std::string &text)
+{
+    std::istringstream  stream(text);
+    std::string         line,
+                        result;
+
+    // JSON configurations are taken as they are
+    size_t      first = text.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && text[first] == '{') return text;
+
+    while (std::getline(stream, line))
+    {
+        line = line.substr(0, line.find('#'));
+
+        size_t      b = line.find_first_not_of(" \t\r"),
+                    e = line.find_last_not_of(" \t\r");
+
+        if (b == std::string::npos) continue;
+
+        if (! result.empty()) result += ", ";
+        result += line.substr(b, e - b + 1);
+    }
+
+    return result;
+}
+
+
+/** \brief Whether a token of the options database is the name of an option,
+ *      rather than a value such as `-1`. */
+bool isOptionName(const std::string &token)
+{
+    return token.size() > 1 && token[0] == '-' &&
+        ! (std::isdigit(token[1]) || token[1] == '.');
+}
+
+} // end of anonymous namespace
+
+
+/* \implements AmgXSolver::getConfig */
+PetscErrorCode AmgXSolver::getConfig(const std::string &config,
+        const ConfigSource source, std::string &cfgText)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    switch (source)
+    {
+        case ConfigSource::File:
+        {
+            int     length = -1;
+
+            // thousands of processes must not all open the same small file
+            if (myGlobalRank == 0)
+            {
+                std::ifstream       file(config);
+                std::stringstream   buffer;
+
+                if (file.good())
+                {
+                    buffer << file.rdbuf();
+                    cfgText = fileToParameters(buffer.str());
+                    length = cfgText.size();
+                }
+            }
+
+            ierr = MPI_Bcast(&length, 1, MPI_INT, 0, globalCpuWorld); CHK;
+
+            if (length < 0)
+                SETERRQ1(globalCpuWorld, PETSC_ERR_FILE_OPEN,
+                        "Can not open the AmgX configuration file %s.\n",
+                        config.c_str());
+
+            cfgText.resize(length);
+            ierr = MPI_Bcast(&cfgText[0], length, MPI_CHAR,
+                    0, globalCpuWorld); CHK;
+
+            break;
+        }
+        case ConfigSource::String:
+        {
+            cfgText = config;
+            break;
+        }
+        case ConfigSource::Options:
+        {
+            char                *all;
+            std::string         token,
+                                head = "-" + config + ":";
+            std::vector<std::string>    tokens;
+
+            ierr = PetscOptionsGetAll(nullptr, &all); CHK;
+
+            std::istringstream  stream(all);
+            while (stream >> token) tokens.push_back(token);
+
+            ierr = PetscFree(all); CHK;
+
+            cfgText.clear();
+
+            for (size_t i = 0; i < tokens.size(); ++i)
+            {
+                PetscBool   used;
+
+                if (tokens[i].compare(0, head.size(), head) != 0) continue;
+
+                if (i + 1 == tokens.size() || isOptionName(tokens[i + 1]))
+                    SETERRQ1(globalCpuWorld, PETSC_ERR_ARG_WRONG,
+                            "The option %s needs a value.\n",
+                            tokens[i].c_str());
+
+                // so that -options_left does not list it
+                ierr = PetscOptionsHasName(nullptr, nullptr,
+                        tokens[i].c_str(), &used); CHK;
+
+                if (! cfgText.empty()) cfgText += ", ";
+                cfgText += tokens[i].substr(head.size()) + "=" + tokens[i + 1];
+
+                i += 1;
+            }
+
+            if (cfgText.empty())
+                SETERRQ1(globalCpuWorld, PETSC_ERR_ARG_NULL,
+                        "No option starts with %s.\n", head.c_str());
+
+            break;
+        }
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::reconfigure */
+PetscErrorCode AmgXSolver::reconfigure(const std::string &config,
+        const ConfigSource source)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    std::string         newText,
+                        gridStats;
+
+    AMGX_config_handle  newCfg = nullptr;
+
+    int                 rings[2] = {0, 0};
+
+    double              tic = MPI_Wtime();
+
+    ierr = waitStage(); CHK;
+
+    if (spare.staged)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "reconfigure can not be called between stageA and swap.\n");
+
+    ierr = getConfig(config, source, newText); CHK;
+
+    // without AmgX objects yet, the first setA picks up the new text
+    if (hasAmgX)
+    {
+        AMGX_SAFE_CALL(AMGX_config_create(&newCfg, newText.c_str()));
+        AMGX_SAFE_CALL(AMGX_config_add_parameters(
+                    &newCfg, "exception_handling=1"));
+
+        rings[0] = ring;
+        AMGX_config_get_default_number_of_rings(newCfg, &rings[1]);
+    }
+
+    // the rank 0 of globalCpuWorld is always in gpuWorld
+    ierr = MPI_Bcast(rings, 2, MPI_INT, 0, globalCpuWorld); CHK;
+
+    // the halo of the uploaded matrix was built for the old rings
+    if (hasA && rings[0] != rings[1])
+    {
+        if (newCfg != nullptr) AMGX_config_destroy(newCfg);
+
+        SETERRQ2(globalCpuWorld, PETSC_ERR_ARG_INCOMP,
+                "The new configuration needs %d halo rings, but the "
+                "matrix was uploaded with %d.\n", rings[1], rings[0]);
+    }
+
+    if (hasAmgX)
+    {
+        // handles of the spare slot were made with the old configuration
+        if (spare.solver != nullptr)
+        {
+            AMGX_solver_destroy(spare.solver);
+            AMGX_matrix_destroy(spare.A);
+            AMGX_vector_destroy(spare.P);
+            AMGX_vector_destroy(spare.RHS);
+
+            spare.solver = nullptr;
+            spare.A = nullptr;
+            spare.P = nullptr;
+            spare.RHS = nullptr;
+        }
+
+        AMGX_solver_destroy(solver);
+        AMGX_config_destroy(cfg);
+
+        cfg = newCfg;
+        ring = rings[1];
+        solverScope = findScope(newText);
+
+        // after a swap, the matrix lives on the resources of its slot
+        AMGX_solver_create(&solver,
+                (activeRsrc >= 0) ? stageRsrc[activeRsrc] : rsrc, mode, cfg);
+
+        if (hasA)
+        {
+            ierr = barrier(gpuWorld); CHK;
+            ierr = setupSolver(false, gridStats); CHK;
+        }
+    }
+    ierr = barrier(globalCpuWorld); CHK;
+
+    cfgText = std::move(newText);
+
+    // the new configuration has its own stopping criteria
+    userTol = 0.0;
+    userMaxIters = 0;
+    amgxTol = 0.0;
+    amgxMaxIters = 0;
+
+    if (hasA)
+    {
+        ierr = parseGridStats(gridStats); CHK;
+        ierr = resetReuse(); CHK;
+
+        addSample(StSetup, MPI_Wtime() - tic);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::setTolerance */
+PetscErrorCode AmgXSolver::setTolerance(const PetscReal tol)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (tol <= 0.0)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_OUTOFRANGE,
+                "The tolerance must be positive.\n");
+
+    userTol = tol;
+
+    ierr = applyStopping(); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::setMaxIters */
+PetscErrorCode AmgXSolver::setMaxIters(const PetscInt maxIters)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (maxIters <= 0)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_OUTOFRANGE,
+                "The maximum number of iterations must be positive.\n");
+
+    userMaxIters = maxIters;
+
+    ierr = applyStopping(); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::applyStopping */
+PetscErrorCode AmgXSolver::applyStopping()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    bool                changed = false;
+
+    std::string         gridStats;
+
+    if (outerKsp != nullptr)
+    {
+        ierr = KSPSetTolerances(outerKsp,
+                (userTol > 0.0) ? userTol : PETSC_DEFAULT,
+                PETSC_DEFAULT, PETSC_DEFAULT,
+                (userMaxIters > 0) ? userMaxIters : PETSC_DEFAULT); CHK;
+    }
+
+    // setA_mat applies them once AmgX exists
+    if (! hasAmgX) PetscFunctionReturn(0);
+
+    ierr = stopAmgX(outerKsp != nullptr, changed); CHK;
+
+    // after a setA that took the host path, AmgX has no matrix to set up
+    if (changed && hasA && hostKsp == nullptr)
+    {
+        ierr = barrier(gpuWorld); CHK;
+        ierr = setupSolver(true, gridStats); CHK;
+
+        // iterations under the new criteria are the new baseline
+        ierr = resetReuse(); CHK;
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::stopAmgX */
+PetscErrorCode AmgXSolver::stopAmgX(const bool outer, bool &changed)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    std::ostringstream  params;
+
+    AMGX_config_handle  newCfg = nullptr;
+
+    // with an outer KSP, each AmgX solve is one preconditioner application
+    // or correction, and stops as the configuration says
+    const PetscReal     tol = outer ? 0.0 : userTol;
+    const PetscInt      maxIters = outer ? 0 : userMaxIters;
+
+    changed = (tol != amgxTol || maxIters != amgxMaxIters);
+
+    if (! changed) PetscFunctionReturn(0);
+
+    // the staged setup uses the spare solver
+    ierr = waitStage(); CHK;
+
+    // the parameters in the configuration may already have values
+    const std::string   prefix =
+        (solverScope == "default") ? "" : solverScope + ":";
+
+    params << "exception_handling=1, allow_configuration_mod=1";
+
+    if (tol > 0.0)
+        params << ", " << prefix << "tolerance="
+            << std::setprecision(17) << tol;
+
+    if (maxIters > 0)
+        params << ", " << prefix << "max_iters=" << maxIters;
+
+    AMGX_SAFE_CALL(AMGX_config_create(&newCfg, cfgText.c_str()));
+    AMGX_SAFE_CALL(AMGX_config_add_parameters(&newCfg, params.str().c_str()));
+
+    // AmgX solvers read the stopping criteria when they are created, so new
+    // ones replace them on the same resources; a resetup on the matrices
+    // they had rebuilds the values of the hierarchy, not its structure
+    if (spare.solver != nullptr)
+    {
+        AMGX_solver_destroy(spare.solver);
+        AMGX_solver_create(&spare.solver,
+                (spare.rsrcId >= 0) ? stageRsrc[spare.rsrcId] : rsrc,
+                mode, newCfg);
+
+        if (spare.staged) AMGX_solver_resetup(spare.solver, spare.A);
+    }
+
+    AMGX_solver_destroy(solver);
+    AMGX_solver_create(&solver,
+            (activeRsrc >= 0) ? stageRsrc[activeRsrc] : rsrc, mode, newCfg);
+
+    AMGX_config_destroy(cfg);
+    cfg = newCfg;
+
+    amgxTol = tol;
+    amgxMaxIters = maxIters;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::findScope */
+std::string AmgXSolver::findScope(const std::string &cfgText)
+{
+    std::string     text = cfgText,
+                    entry;
+
+    std::replace(text.begin(), text.end(), ',', '\n');
+
+    std::istringstream  stream(text);
+
+    // the outermost solver is the one set without a scope in front
+    while (std::getline(stream, entry))
+    {
+        size_t      b = entry.find_first_not_of(" \t\r");
+
+        if (b == std::string::npos) continue;
+
+        entry = entry.substr(b);
+        if (entry.compare(0, 8, "default:") == 0) entry = entry.substr(8);
+
+        if (entry.compare(0, 7, "solver(") != 0) continue;
+
+        size_t      e = entry.find(')');
+
+        if (e != std::string::npos) return entry.substr(7, e - 7);
+    }
+
+    return "default";
+}
@@ -28,6 +28,8 @@
 
 #include <numeric>
 
+// the mock CUDA runtime has no compiler, so the kernel becomes a host loop
+#if !defined(AMGX_MOCK)
 /*
     Changes local row offsets to describe the consolidated row space on
     the root rank.
@@ -39,6 +41,7 @@ __global__ void fixConsolidatedRowOffsets(int nLocalRows, int offset, int* rowOf
         rowOffsets[i] += offset;
     }
 }
+#endif
 
 // A set of handles to the device data storing a consolidated CSR matrix
 struct ConsolidationHandles
@@ -58,8 +61,9 @@ PetscErrorCode AmgXSolver::initializeConsolidation(
 {
     PetscFunctionBeginUser;
 
-    // Check if multiple ranks are associated with a device
-    if (devWorldSize == 1)
+    // Check if multiple ranks are associated with a device; in host modes
+    // every rank runs its own AmgX instance, so there is nothing to merge
+    if (devWorldSize == 1 || onHost)
     {
         consolidationStatus = ConsolidationStatus::None;
         PetscFunctionReturn(0);
@@ -76,7 +80,7 @@ PetscErrorCode AmgXSolver::initializeConsolidation(
 
     // Fetch to all the number of non zeros on each rank
     ierr = MPI_Iallgather(&nLocalNz, 1, MPI_INT, nnzInDevWorld.data(), 1, MPI_INT, devWorld, &req[1]); CHK;
-    MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+    ierr = waitAll(2, req); CHK;
 
     // Calculate consolidate number of rows, non-zeros, and calculate row, non-zero displacements
     nConsNz = std::accumulate(nnzInDevWorld.begin(), nnzInDevWorld.end(), 0);
@@ -155,6 +159,8 @@ PetscErrorCode AmgXSolver::consolidateMatrix(
 {
     PetscFunctionBeginUser;
 
+    int ierr = eventBegin(EvConsolidate); CHK;
+
     // Consolidation has been previously used, must deallocate the structures
     if (consolidationStatus != ConsolidationStatus::Uninitialized)
     {
@@ -175,6 +181,7 @@ PetscErrorCode AmgXSolver::consolidateMatrix(
     case ConsolidationStatus::None:
     {
         // Consolidation is not required
+        ierr = eventEnd(EvConsolidate); CHK;
         PetscFunctionReturn(0);
     }
     case ConsolidationStatus::Uninitialized:
@@ -186,29 +193,43 @@ PetscErrorCode AmgXSolver::consolidateMatrix(
     case ConsolidationStatus::Device:
     {
         // Copy the data to the consolidation buffer
-        CHECK(cudaMemcpy(&rowOffsetsCons[rowDispls[myDevWorldRank]], rowOffsets, sizeof(PetscInt) * nLocalRows, cudaMemcpyDefault));
-        CHECK(cudaMemcpy(&colIndicesGlobalCons[nzDispls[myDevWorldRank]], colIndicesGlobal, sizeof(PetscInt) * nLocalNz, cudaMemcpyDefault));
-        CHECK(cudaMemcpy(&valuesCons[nzDispls[myDevWorldRank]], values, sizeof(PetscScalar) * nLocalNz, cudaMemcpyDefault));
+        CHECK(cudaMemcpyAsync(&rowOffsetsCons[rowDispls[myDevWorldRank]], rowOffsets, sizeof(PetscInt) * nLocalRows, cudaMemcpyDefault, stream));
+        CHECK(cudaMemcpyAsync(&colIndicesGlobalCons[nzDispls[myDevWorldRank]], colIndicesGlobal, sizeof(PetscInt) * nLocalNz, cudaMemcpyDefault, stream));
+        CHECK(cudaMemcpyAsync(&valuesCons[nzDispls[myDevWorldRank]], values, sizeof(PetscScalar) * nLocalNz, cudaMemcpyDefault, stream));
 
-        // cudaMemcpy does not block the host in the cases above, device to device copies,
-        // so sychronize with device to ensure operation is complete. Barrier on all devWorld
-        // ranks to ensure full arrays are populated before the root process uses the data.
-        CHECK(cudaDeviceSynchronize());
-        int ierr = MPI_Barrier(devWorld); CHK;
+        // The copies are on the stream of this instance, so sychronize with it to ensure they
+        // are complete. Barrier on all devWorld ranks to ensure full arrays are populated
+        // before the root process uses the data.
+        CHECK(cudaStreamSynchronize(stream));
+        ierr = barrier(devWorld); CHK;
 
         if (gpuProc == 0)
         {
             // Adjust merged row offsets so that they are correct for the consolidated matrix
             for (int i = 1; i < devWorldSize; ++i)
             {
+#if defined(AMGX_MOCK)
+                for (int j = 0; j < nRowsInDevWorld[i]; ++j)
+                {
+                    rowOffsetsCons[rowDispls[i] + j] += nzDispls[i];
+                }
+#else
                 int nthreads = 128;
                 int nblocks = nRowsInDevWorld[i] / nthreads + 1;
-                fixConsolidatedRowOffsets<<<nblocks, nthreads>>>(nRowsInDevWorld[i], nzDispls[i], &rowOffsetsCons[rowDispls[i]]);
+                fixConsolidatedRowOffsets<<<nblocks, nthreads, 0, stream>>>(nRowsInDevWorld[i], nzDispls[i], &rowOffsetsCons[rowDispls[i]]);
+#endif
             }
 
             // Manually add the last entry of the rowOffsets list, which is the
             // number of non-zeros in the CSR matrix
-            CHECK(cudaMemcpy(&rowOffsetsCons[nConsRows], &nConsNz, sizeof(int), cudaMemcpyDefault));
+            CHECK(cudaMemcpyAsync(&rowOffsetsCons[nConsRows], &nConsNz, sizeof(int), cudaMemcpyDefault, stream));
+
+# if defined(PETSC_HAVE_CUDA)
+            if (onLogThread())
+            {
+                ierr = PetscLogGpuFlops(nConsRows - nRowsInDevWorld[0]); CHK;
+            }
+# endif
         }
         else
         {
@@ -217,17 +238,17 @@ PetscErrorCode AmgXSolver::consolidateMatrix(
             CHECK(cudaIpcCloseMemHandle(colIndicesGlobalCons));
         }
 
-        CHECK(cudaDeviceSynchronize());
+        CHECK(cudaStreamSynchronize(stream));
         break;
     }
     case ConsolidationStatus::Host:
     {
         // Gather the matrix data to the root rank for consolidation
         MPI_Request req[3];
-        int ierr = MPI_Igatherv(rowOffsets, nLocalRows, MPI_INT, rowOffsetsCons, nRowsInDevWorld.data(), rowDispls.data(), MPI_INT, 0, devWorld, &req[0]); CHK;
+        ierr = MPI_Igatherv(rowOffsets, nLocalRows, MPI_INT, rowOffsetsCons, nRowsInDevWorld.data(), rowDispls.data(), MPI_INT, 0, devWorld, &req[0]); CHK;
         ierr = MPI_Igatherv(colIndicesGlobal, nLocalNz, MPI_INT, colIndicesGlobalCons, nnzInDevWorld.data(), nzDispls.data(), MPI_INT, 0, devWorld, &req[1]); CHK;
         ierr = MPI_Igatherv(values, nLocalNz, MPI_DOUBLE, valuesCons, nnzInDevWorld.data(), nzDispls.data(), MPI_DOUBLE, 0, devWorld, &req[2]); CHK;
-        MPI_Waitall(3, req, MPI_STATUSES_IGNORE);
+        ierr = waitAll(3, req); CHK;
 
         if (gpuProc == 0)
         {
@@ -243,6 +264,11 @@ PetscErrorCode AmgXSolver::consolidateMatrix(
             // Manually add the last entry of the rowOffsets list, which is the
             // number of non-zeros in the CSR matrix
             rowOffsetsCons[nConsRows] = nConsNz;
+
+            if (onLogThread())
+            {
+                ierr = PetscLogFlops(nConsRows - nRowsInDevWorld[0]); CHK;
+            }
         }
 
         break;
@@ -256,22 +282,31 @@ PetscErrorCode AmgXSolver::consolidateMatrix(
 
     }
 
+    ierr = eventEnd(EvConsolidate); CHK;
+
     PetscFunctionReturn(0);
 }
 
 /* \implements AmgXSolver::reconsolidateValues */
+template <typename T>
 PetscErrorCode AmgXSolver::reconsolidateValues(
     const PetscInt nLocalNz,
-    const PetscScalar* values)
+    const T* values)
 {
     PetscFunctionBeginUser;
 
+    // the consolidation buffer holds PetscScalar, so it also fits floats
+    T *valuesC = reinterpret_cast<T*>(valuesCons);
+
+    int ierr = eventBegin(EvConsolidate); CHK;
+
     switch (consolidationStatus)
     {
 
     case ConsolidationStatus::None:
     {
         // Consolidation is not required
+        ierr = eventEnd(EvConsolidate); CHK;
         PetscFunctionReturn(0);
     }
     case ConsolidationStatus::Uninitialized:
@@ -282,21 +317,22 @@ PetscErrorCode AmgXSolver::reconsolidateValues(
     }
     case ConsolidationStatus::Device:
     {
-        CHECK(cudaDeviceSynchronize());
-        int ierr = MPI_Barrier(devWorld); CHK;
+        // AmgX works on the default stream and may still read the last values
+        CHECK(cudaStreamSynchronize(0));
+        ierr = barrier(devWorld); CHK;
 
         // The data is already on the GPU so consolidate there
-        CHECK(cudaMemcpy(&valuesCons[nzDispls[myDevWorldRank]], values, sizeof(PetscScalar) * nLocalNz, cudaMemcpyDefault));
+        CHECK(cudaMemcpyAsync(&valuesC[nzDispls[myDevWorldRank]], values, sizeof(T) * nLocalNz, cudaMemcpyDefault, stream));
 
-        CHECK(cudaDeviceSynchronize());
-        ierr = MPI_Barrier(devWorld); CHK;
+        CHECK(cudaStreamSynchronize(stream));
+        ierr = barrier(devWorld); CHK;
 
         break;
     }
     case ConsolidationStatus::Host:
     {
         // Gather the matrix values to the root rank for consolidation
-        int ierr = MPI_Gatherv(values, nLocalNz, MPI_DOUBLE, valuesCons, nnzInDevWorld.data(), nzDispls.data(), MPI_DOUBLE, 0, devWorld); CHK;
+        ierr = MPI_Gatherv(values, nLocalNz, mpiType(values), valuesC, nnzInDevWorld.data(), nzDispls.data(), mpiType(values), 0, devWorld); CHK;
         break;
     }
     default:
@@ -308,9 +344,17 @@ PetscErrorCode AmgXSolver::reconsolidateValues(
 
     }
 
+    ierr = eventEnd(EvConsolidate); CHK;
+
     PetscFunctionReturn(0);
 }
 
+template PetscErrorCode AmgXSolver::reconsolidateValues(
+    const PetscInt nLocalNz, const PetscScalar* values);
+
+template PetscErrorCode AmgXSolver::reconsolidateValues(
+    const PetscInt nLocalNz, const float* values);
+
 /* \implements AmgXSolver::freeConsStructure */
 PetscErrorCode AmgXSolver::freeConsStructure()
 {
@@ -0,0 +1,152 @@
+/**
+ * \file hierarchy.cpp
+ * \brief Definition of member functions regarding the AMG hierarchy.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <sstream>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::getHierarchyStats */
+PetscErrorCode AmgXSolver::getHierarchyStats(HierarchyStats &stats)
+{
+    PetscFunctionBeginUser;
+
+    stats = hierarchy;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::setupSolver */
+PetscErrorCode AmgXSolver::setupSolver(const bool resetup, std::string &log)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    Event               e = resetup ? EvResetup : EvSetup;
+
+    ierr = eventBegin(e); CHK;
+
+    // grid statistics are printed by AmgX during the setup
+    printCapture = &log;
+
+    if (resetup)
+        AMGX_solver_resetup(solver, AmgXA);
+    else
+        AMGX_solver_setup(solver, AmgXA);
+
+    printCapture = nullptr;
+
+    ierr = eventEnd(e); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::parseGridStats */
+PetscErrorCode AmgXSolver::parseGridStats(const std::string &log)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    HierarchyStats      h;
+
+    double              info[4];
+
+    // AmgX prints something like the following; the PARTS column only
+    // exists in newer versions, and (D) becomes (H) for levels on the host
+    //
+    //         Number of Levels: 2
+    //            LVL         ROWS               NNZ  PARTS    SPRSTY       Mem (GB)
+    //         ----------------------------------------------------------------------
+    //           0(D)       262144           1810432      1    2.63e-05         0.0236
+    //           1(D)        32768            277944      1     0.000259        0.00373
+    //         ----------------------------------------------------------------------
+    //         Grid Complexity: 1.125
+    //         Operator Complexity: 1.15352
+    //         Total Memory Usage: 0.0273301 GB
+    if (myGlobalRank == 0)
+    {
+        std::istringstream  stream(log);
+        std::string         line;
+
+        while (std::getline(stream, line))
+        {
+            const char      *c = line.c_str();
+            const char      *colon = std::strchr(c, ':');
+
+            int             level;
+            char            loc;
+            long long       rows,
+                            nnz;
+
+            if (std::strstr(c, "Number of Levels:"))
+            {
+                // a new hierarchy; only the last one printed matters
+                h = HierarchyStats();
+                h.nLevels = std::atoi(colon + 1);
+            }
+            else if (std::strstr(c, "Grid Complexity:"))
+                h.gridComplexity = std::atof(colon + 1);
+            else if (std::strstr(c, "Operator Complexity:"))
+                h.operatorComplexity = std::atof(colon + 1);
+            else if (std::strstr(c, "Total Memory Usage:"))
+                h.totalMemory = std::atof(colon + 1);
+            else if (std::sscanf(c, " %d(%c) %lld %lld",
+                        &level, &loc, &rows, &nnz) == 4)
+            {
+                // the memory estimate is the last column
+                const char  *last = c + line.find_last_of(" \t") + 1;
+
+                h.rows.push_back(rows);
+                h.nnz.push_back(nnz);
+                h.memory.push_back(std::atof(last));
+            }
+        }
+
+        // ignore output that does not look like complete grid statistics
+        if (h.nLevels != static_cast<int>(h.rows.size())) h.nLevels = 0;
+    }
+
+    info[0] = h.nLevels;
+    info[1] = h.gridComplexity;
+    info[2] = h.operatorComplexity;
+    info[3] = h.totalMemory;
+    ierr = MPI_Bcast(info, 4, MPI_DOUBLE, 0, globalCpuWorld); CHK;
+
+    // no (new) grid statistics; keep what we had
+    if (info[0] == 0) PetscFunctionReturn(0);
+
+    h.nLevels = info[0];
+    h.gridComplexity = info[1];
+    h.operatorComplexity = info[2];
+    h.totalMemory = info[3];
+
+    h.rows.resize(h.nLevels);
+    h.nnz.resize(h.nLevels);
+    h.memory.resize(h.nLevels);
+
+    ierr = MPI_Bcast(h.rows.data(), h.nLevels,
+            MPI_LONG_LONG, 0, globalCpuWorld); CHK;
+    ierr = MPI_Bcast(h.nnz.data(), h.nLevels,
+            MPI_LONG_LONG, 0, globalCpuWorld); CHK;
+    ierr = MPI_Bcast(h.memory.data(), h.nLevels,
+            MPI_DOUBLE, 0, globalCpuWorld); CHK;
+
+    hierarchy = h;
+
+    PetscFunctionReturn(0);
+}
@@ -0,0 +1,165 @@
+/**
+ * \file host.cpp
+ * \brief Definition of member functions regarding small systems solved on
+ *        the host.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::initHost */
+PetscErrorCode AmgXSolver::initHost()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    hostRows = 0;
+    hostNnz = 0;
+
+    ierr = PetscOptionsGetInt(nullptr, nullptr,
+            "-amgx_host_rows", &hostRows, nullptr); CHK;
+    ierr = PetscOptionsGetInt(nullptr, nullptr,
+            "-amgx_host_nnz", &hostNnz, nullptr); CHK;
+
+    if (hostRows < 0 || hostNnz < 0)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_OUTOFRANGE,
+                "-amgx_host_rows and -amgx_host_nnz can not be negative.\n");
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::setHost */
+PetscErrorCode AmgXSolver::setHost(const Mat &A, bool &done)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            nGlobalRows;
+
+    MatInfo             info;
+
+    PC                  pc;
+
+    double              tic = MPI_Wtime();
+
+    done = false;
+
+    ierr = KSPDestroy(&hostKsp); CHK;
+
+    if (hostRows == 0) PetscFunctionReturn(0);
+
+    // the sizes are global, so all processes take the same path
+    ierr = MatGetSize(A, &nGlobalRows, nullptr); CHK;
+
+    if (nGlobalRows > hostRows) PetscFunctionReturn(0);
+
+    if (hostNnz > 0)
+    {
+        ierr = MatGetInfo(A, MAT_GLOBAL_SUM, &info); CHK;
+
+        if (info.nz_used > hostNnz) PetscFunctionReturn(0);
+    }
+
+    // nothing of a previous matrix given to AmgX is used from now on
+    ierr = ISDestroy(&lastDevIS); CHK;
+    ierr = VecScatterDestroy(&scatterLhs); CHK;
+    ierr = VecScatterDestroy(&scatterRhs); CHK;
+    ierr = VecDestroy(&redistLhs); CHK;
+    ierr = VecDestroy(&redistRhs); CHK;
+    ierr = KSPDestroy(&outerKsp); CHK;
+    dropTol = 0.0;
+    keptNz.clear();
+
+    // a gathered copy on every process; its setup and solves cost less than
+    // launching AmgX for so few rows
+    ierr = KSPCreate(PetscObjectComm((PetscObject) A), &hostKsp); CHK;
+    ierr = KSPSetOptionsPrefix(hostKsp, "amgx_host_"); CHK;
+    ierr = KSPSetType(hostKsp, KSPPREONLY); CHK;
+
+    ierr = KSPGetPC(hostKsp, &pc); CHK;
+    ierr = PCSetType(pc, PCREDUNDANT); CHK;
+
+    ierr = KSPSetOperators(hostKsp, A, A); CHK;
+    ierr = KSPSetFromOptions(hostKsp); CHK;
+
+    // factorize now, so that solves only do the triangular solves
+    ierr = KSPSetUp(hostKsp); CHK;
+    ierr = KSPSetUpOnBlocks(hostKsp); CHK;
+
+    // there is no AMG hierarchy on this path
+    hierarchy = HierarchyStats();
+    ierr = resetReuse(); CHK;
+
+    hasA = true;
+    done = true;
+
+    addSample(StSetup, MPI_Wtime() - tic);
+
+    ierr = recordSetA(A, tic); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::updateHost */
+PetscErrorCode AmgXSolver::updateHost(const Mat &A)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    double              tic = MPI_Wtime();
+
+    // PETSc notices the new values and factorizes again
+    ierr = KSPSetOperators(hostKsp, A, A); CHK;
+    ierr = KSPSetUp(hostKsp); CHK;
+    ierr = KSPSetUpOnBlocks(hostKsp); CHK;
+
+    addSample(StResetup, MPI_Wtime() - tic);
+
+    ierr = recordUpdateA(A, tic); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve_host */
+PetscErrorCode AmgXSolver::solve_host(Vec &p, Vec &b, SolveReport *report)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    KSPConvergedReason  reason;
+    PetscInt            iters;
+
+    ierr = eventBegin(EvSolve); CHK;
+    ierr = KSPSolve(hostKsp, b, p); CHK;
+    ierr = eventEnd(EvSolve); CHK;
+
+    ierr = KSPGetConvergedReason(hostKsp, &reason); CHK;
+    ierr = KSPGetIterationNumber(hostKsp, &iters); CHK;
+
+    if (report == nullptr)
+    {
+        if (reason < 0) SETERRQ1(globalCpuWorld, PETSC_ERR_CONV_FAILED,
+                "The direct solver on the host failed to solve the system! "
+                "The reason is %d.\n", (int) reason);
+
+        PetscFunctionReturn(0);
+    }
+
+    report->status = (reason < 0) ? AMGX_SOLVE_FAILED : AMGX_SOLVE_SUCCESS;
+    report->iters = iters;
+    report->residuals.clear();
+
+    PetscFunctionReturn(0);
+}
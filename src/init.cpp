@@ -17,9 +17,10 @@
 
 /* \implements AmgXSolver::AmgXSolver */
 AmgXSolver::AmgXSolver(const MPI_Comm &comm,
-        const std::string &modeStr, const std::string &cfgFile)
+        const std::string &modeStr, const std::string &config,
+        const ConfigSource source)
 {
-    initialize(comm, modeStr, cfgFile);
+    initialize(comm, modeStr, config, source);
 }
 
 
@@ -32,7 +33,8 @@ AmgXSolver::~AmgXSolver()
 
 /* \implements AmgXSolver::initialize */
 PetscErrorCode AmgXSolver::initialize(const MPI_Comm &comm,
-        const std::string &modeStr, const std::string &cfgFile)
+        const std::string &modeStr, const std::string &config,
+        const ConfigSource source)
 {
     PetscErrorCode      ierr;
 
@@ -42,9 +44,15 @@ PetscErrorCode AmgXSolver::initialize(const MPI_Comm &comm,
     if (isInitialized) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE,
             "This AmgXSolver instance has been initialized on this process.");
 
+    // register the PETSc log events of the wrapper, if not yet registered
+    ierr = registerEvents(); CHK;
+
     // increase the number of AmgXSolver instances
     count += 1;
 
+    // remember the initialization order of this instance
+    serial = serialCount++;
+
     // get the name of this node
     int     len;
     char    name[MPI_MAX_PROCESSOR_NAME];
@@ -57,11 +65,37 @@ PetscErrorCode AmgXSolver::initialize(const MPI_Comm &comm,
     // initialize communicators and corresponding information
     ierr = initMPIcomms(comm); CHK;
 
-    // only processes in gpuWorld are required to initialize AmgX
-    if (gpuProc == 0)
-    {
-        ierr = initAmgX(cfgFile); CHK;
-    }
+    // the same AmgX configuration on all processes, read only once
+    ierr = getConfig(config, source, cfgText); CHK;
+
+    // start recording the timeline trace, if requested
+    ierr = initTrace(); CHK;
+
+    // start recording the calls to this instance, if requested
+    // replays need their own configuration if it was not a file
+    ierr = initRecord(modeStr,
+            (source == ConfigSource::File) ? config : std::string()); CHK;
+
+    // read the policy for reusing hierarchies across updateA
+    ierr = initReuse(); CHK;
+
+    // read -amgx_refine
+    ierr = initRefine(); CHK;
+
+    // read the sizes below which setA solves on the host
+    ierr = initHost(); CHK;
+
+    // decide whether stageA may set up on a helper thread
+    ierr = initStage(); CHK;
+
+    // read -amgx_thread_safe
+    ierr = initThreads(); CHK;
+
+    // AmgX objects are only created by the first setA or stageA, so that
+    // instances that never get a matrix do not touch the devices
+
+    // pay for the first setup and solve now, if requested
+    ierr = prewarm(); CHK;
 
     // a bool indicating if this instance is initialized
     isInitialized = true;
@@ -79,6 +113,39 @@ PetscErrorCode AmgXSolver::initMPIcomms(const MPI_Comm &comm)
 
     PetscFunctionBeginUser;
 
+    // only the first instance on comm works out its topology
+    ierr = getTopology(comm); CHK;
+
+    ierr = MPI_Comm_dup(topology->globalCpuWorld, &globalCpuWorld); CHK;
+    ierr = MPI_Comm_set_name(globalCpuWorld, "globalCpuWorld"); CHK;
+
+    ierr = MPI_Comm_dup(topology->localCpuWorld, &localCpuWorld); CHK;
+    ierr = MPI_Comm_set_name(localCpuWorld, "localCpuWorld"); CHK;
+
+    ierr = MPI_Comm_dup(topology->devWorld, &devWorld); CHK;
+    ierr = MPI_Comm_set_name(devWorld, "devWorld"); CHK;
+
+    gpuWorld = MPI_COMM_NULL;
+    if (gpuProc == 0)
+    {
+        ierr = MPI_Comm_dup(topology->gpuWorld, &gpuWorld); CHK;
+        ierr = MPI_Comm_set_name(gpuWorld, "gpuWorld"); CHK;
+    }
+
+    // the device was set by the thread of the first instance
+    ierr = bindDevice(); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::splitComms */
+PetscErrorCode AmgXSolver::splitComms(const MPI_Comm &comm)
+{
+    PetscErrorCode      ierr;
+
+    PetscFunctionBeginUser;
+
     // duplicate the global communicator
     ierr = MPI_Comm_dup(comm, &globalCpuWorld); CHK;
     ierr = MPI_Comm_set_name(globalCpuWorld, "globalCpuWorld"); CHK;
@@ -142,14 +209,22 @@ PetscErrorCode AmgXSolver::setDeviceCount()
 {
     PetscFunctionBeginUser;
 
+    PetscErrorCode      ierr;
+
     // get the number of devices that AmgX solvers can use
     switch (mode)
     {
         case AMGX_mode_dDDI: // for GPU cases, nDevs is the # of local GPUs
         case AMGX_mode_dDFI: // for GPU cases, nDevs is the # of local GPUs
         case AMGX_mode_dFFI: // for GPU cases, nDevs is the # of local GPUs
-            // get the number of total cuda devices
-            CHECK(cudaGetDeviceCount(&nDevs));
+            // get the number of total cuda devices; other local processes do
+            // not load the CUDA driver only to count the same devices
+            if (myLocalRank == 0)
+            {
+                CHECK(cudaGetDeviceCount(&nDevs));
+            }
+
+            ierr = MPI_Bcast(&nDevs, 1, MPI_INT, 0, localCpuWorld); CHK;
 
             // Check whether there is at least one CUDA device on this node
             if (nDevs == 0) SETERRQ1(MPI_COMM_WORLD, PETSC_ERR_SUP_SYS,
@@ -206,20 +281,23 @@ PetscErrorCode AmgXSolver::setDeviceIDs()
         }
     }
 
-    // Set the device for each rank
-    cudaSetDevice(devID);
+    // Set the device for each rank talking to AmgX; other ranks and host
+    // modes do not create a CUDA context here
+    if (! onHost && gpuProc == 0) cudaSetDevice(devID);
 
     PetscFunctionReturn(0);
 }
 
 
 /* \implements AmgXSolver::initAmgX */
-PetscErrorCode AmgXSolver::initAmgX(const std::string &cfgFile)
+PetscErrorCode AmgXSolver::initAmgX()
 {
     PetscFunctionBeginUser;
 
+    PetscErrorCode      ierr;
+
     // only the first instance (AmgX solver) is in charge of initializing AmgX
-    if (count == 1)
+    if (amgxCount == 0)
     {
         // initialize AmgX
         AMGX_SAFE_CALL(AMGX_initialize());
@@ -230,20 +308,32 @@ PetscErrorCode AmgXSolver::initAmgX(const std::string &cfgFile)
         // only the master process can output something on the screen
         AMGX_SAFE_CALL(AMGX_register_print_callback(
                     [](const char *msg, int length)->void
-                    {PetscPrintf(PETSC_COMM_WORLD, "%s", msg);}));
+                    {
+                        if (printMuted) return;
+                        if (printCapture) printCapture->append(msg, length);
+                        PetscPrintf(PETSC_COMM_WORLD, "%s", msg);
+                    }));
 
         // let AmgX to handle errors returned
         AMGX_SAFE_CALL(AMGX_install_signal_handler());
     }
 
     // create an AmgX configure object
-    AMGX_SAFE_CALL(AMGX_config_create_from_file(&cfg, cfgFile.c_str()));
+    AMGX_SAFE_CALL(AMGX_config_create(&cfg, cfgText.c_str()));
 
     // let AmgX handle returned error codes internally
     AMGX_SAFE_CALL(AMGX_config_add_parameters(&cfg, "exception_handling=1"));
 
-    // create an AmgX resource object, only the first instance is in charge
-    if (count == 1) AMGX_resources_create(&rsrc, cfg, &gpuWorld, 1, &devID);
+    // setA_mat adds those of setTolerance and setMaxIters, if any
+    amgxTol = 0.0;
+    amgxMaxIters = 0;
+
+    // setTolerance and setMaxIters change parameters of this scope
+    solverScope = findScope(cfgText);
+
+    // share an AmgX resource object with instances on the same processes and
+    // devices, or create one
+    ierr = acquireResources(); CHK;
 
     // create AmgX vector object for unknowns and RHS
     AMGX_vector_create(&AmgXP, rsrc, mode);
@@ -258,6 +348,24 @@ PetscErrorCode AmgXSolver::initAmgX(const std::string &cfgFile)
     // obtain the default number of rings based on current configuration
     AMGX_config_get_default_number_of_rings(cfg, &ring);
 
+    amgxCount += 1;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::startAmgX */
+PetscErrorCode AmgXSolver::startAmgX()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (hasAmgX || gpuWorld == MPI_COMM_NULL) PetscFunctionReturn(0);
+
+    ierr = initAmgX(); CHK;
+    hasAmgX = true;
+
     PetscFunctionReturn(0);
 }
 
@@ -279,8 +387,16 @@ PetscErrorCode AmgXSolver::finalize()
         PetscFunctionReturn(0);
     }
 
-    // only processes using GPU are required to destroy AmgX content
-    if (gpuProc == 0)
+    // write the timeline trace and statistics while the communicators exist
+    ierr = writeTrace(); CHK;
+    ierr = writeStats(); CHK;
+    ierr = closeRecord(); CHK;
+
+    // wait for and destroy a staged setup, if any
+    ierr = finalizeStage(); CHK;
+
+    // only instances that created AmgX content are required to destroy it
+    if (hasAmgX)
     {
         // destroy solver instance
         AMGX_solver_destroy(solver);
@@ -292,10 +408,25 @@ PetscErrorCode AmgXSolver::finalize()
         AMGX_vector_destroy(AmgXP);
         AMGX_vector_destroy(AmgXRHS);
 
-        // only the last instance need to destroy resource and finalizing AmgX
-        if (count == 1)
+        // resources of staged setups go once no handle uses them
+        for (int i = 0; i < 2; ++i)
+        {
+            if (stageRsrc[i] == nullptr) continue;
+
+            AMGX_resources_destroy(stageRsrc[i]);
+            stageRsrc[i] = nullptr;
+            ierr = MPI_Comm_free(&stageComm[i]); CHK;
+        }
+        activeRsrc = -1;
+
+        // the resource object goes with its last user
+        ierr = releaseResources(); CHK;
+
+        amgxCount -= 1;
+
+        // only the last instance need to finalize AmgX
+        if (amgxCount == 0)
         {
-            AMGX_resources_destroy(rsrc);
             AMGX_SAFE_CALL(AMGX_config_destroy(cfg));
 
             AMGX_SAFE_CALL(AMGX_finalize_plugins());
@@ -306,17 +437,31 @@ PetscErrorCode AmgXSolver::finalize()
             AMGX_config_destroy(cfg);
         }
 
-        // destroy gpuWorld
+        hasAmgX = false;
+    }
+
+    // destroy gpuWorld
+    if (gpuProc == 0)
+    {
         ierr = MPI_Comm_free(&gpuWorld); CHK;
     }
 
     finalizeConsolidation();
 
+    // no copy of this instance is pending after this
+    ierr = finalizeThreads(); CHK;
+
     // destroy PETSc objects
     ierr = VecScatterDestroy(&scatterLhs); CHK;
     ierr = VecScatterDestroy(&scatterRhs); CHK;
     ierr = VecDestroy(&redistLhs); CHK;
     ierr = VecDestroy(&redistRhs); CHK;
+    ierr = ISDestroy(&lastDevIS); CHK;
+    ierr = KSPDestroy(&outerKsp); CHK;
+    ierr = KSPDestroy(&hostKsp); CHK;
+    ierr = MatNullSpaceDestroy(&nullSpace); CHK;
+    ierr = VecDestroy(&nullRhs); CHK;
+    keptNz.clear();
 
     // re-set necessary variables in case users want to reuse
     // the variable of this instance for a new instance
@@ -324,12 +469,17 @@ PetscErrorCode AmgXSolver::finalize()
     ierr = MPI_Comm_free(&globalCpuWorld); CHK;
     ierr = MPI_Comm_free(&localCpuWorld); CHK;
     ierr = MPI_Comm_free(&devWorld); CHK;
+    ierr = releaseTopology(); CHK;
 
     // decrease the number of instances
     count -= 1;
 
     // change status
     isInitialized = false;
+    hasA = false;
+    userTol = 0.0;
+    userMaxIters = 0;
+    cfgText.clear();
 
     PetscFunctionReturn(0);
 }
@@ -0,0 +1,197 @@
+/**
+ * \file log.cpp
+ * \brief Definition of member functions regarding performance logging.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// CUDA
+# include <cuda_runtime.h>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::registerEvents */
+PetscErrorCode AmgXSolver::registerEvents()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    // events only have to be registered once per PETSc session
+    if (eventsRegistered) PetscFunctionReturn(0);
+
+    ierr = PetscClassIdRegister("AmgXSolver", &classId); CHK;
+
+    for (int e = 0; e < nEvents; ++e)
+    {
+        ierr = PetscLogEventRegister(eventNames[e], classId, &events[e]); CHK;
+    }
+
+    // PETSc forgets all events at PetscFinalize, so do we
+    ierr = PetscRegisterFinalize(unregisterEvents); CHK;
+
+    eventsRegistered = PETSC_TRUE;
+    logThread = std::this_thread::get_id();
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::unregisterEvents */
+PetscErrorCode AmgXSolver::unregisterEvents()
+{
+    PetscFunctionBeginUser;
+
+    eventsRegistered = PETSC_FALSE;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::eventBegin */
+PetscErrorCode AmgXSolver::eventBegin(const Event e)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (onLogThread())
+    {
+        ierr = PetscLogEventBegin(events[e], 0, 0, 0, 0); CHK;
+    }
+
+    phaseBegin[e] = MPI_Wtime();
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::eventEnd */
+PetscErrorCode AmgXSolver::eventEnd(const Event e)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (onLogThread())
+    {
+        ierr = PetscLogEventEnd(events[e], 0, 0, 0, 0); CHK;
+    }
+
+    double      end = MPI_Wtime();
+
+    phaseTime[e] += end - phaseBegin[e];
+
+    if (traceEnabled)
+    {
+        if (e == EvMPIWait) traceWait += end - phaseBegin[e];
+
+        // overwrite the oldest record once the ring buffer is full
+        traceBuffer[traceNext % traceBuffer.size()] =
+            {e, phaseBegin[e] - traceOrigin, end - traceOrigin};
+        traceNext += 1;
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::logCpuToGpu */
+PetscErrorCode AmgXSolver::logCpuToGpu(
+        const void *ptr, const PetscLogDouble bytes)
+{
+    PetscFunctionBeginUser;
+
+    // PETSc only keeps track of host-device traffic when built with CUDA
+# if defined(PETSC_HAVE_CUDA)
+    PetscErrorCode      ierr;
+
+    // nothing is copied to a device in host modes
+    if (onHost) PetscFunctionReturn(0);
+
+    if (onLogThread() && ! isDevicePtr(ptr))
+    {
+        ierr = PetscLogCpuToGpu(bytes); CHK;
+    }
+# else
+    (void) ptr;
+    (void) bytes;
+# endif
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::logGpuToCpu */
+PetscErrorCode AmgXSolver::logGpuToCpu(
+        const void *ptr, const PetscLogDouble bytes)
+{
+    PetscFunctionBeginUser;
+
+# if defined(PETSC_HAVE_CUDA)
+    PetscErrorCode      ierr;
+
+    if (onHost) PetscFunctionReturn(0);
+
+    if (onLogThread() && ! isDevicePtr(ptr))
+    {
+        ierr = PetscLogGpuToCpu(bytes); CHK;
+    }
+# else
+    (void) ptr;
+    (void) bytes;
+# endif
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::isDevicePtr */
+bool AmgXSolver::isDevicePtr(const void *ptr)
+{
+    cudaPointerAttributes   att;
+    cudaError_t             err = cudaPointerGetAttributes(&att, ptr);
+
+    // older CUDA runtimes report plain host pointers as an error; clear it
+    if (err != cudaSuccess)
+    {
+        cudaGetLastError();
+        return false;
+    }
+
+    return att.type == cudaMemoryTypeDevice;
+}
+
+
+/* \implements AmgXSolver::barrier */
+PetscErrorCode AmgXSolver::barrier(const MPI_Comm &comm)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = eventBegin(EvMPIWait); CHK;
+    ierr = MPI_Barrier(comm); CHK;
+    ierr = eventEnd(EvMPIWait); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::waitAll */
+PetscErrorCode AmgXSolver::waitAll(const int n, MPI_Request *req)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = eventBegin(EvMPIWait); CHK;
+    ierr = MPI_Waitall(n, req, MPI_STATUSES_IGNORE); CHK;
+    ierr = eventEnd(EvMPIWait); CHK;
+
+    PetscFunctionReturn(0);
+}
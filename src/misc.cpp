@@ -23,14 +23,20 @@ PetscErrorCode AmgXSolver::setMode(const std::string &modeStr)
         mode = AMGX_mode_dDFI;
     else if (modeStr == "dFFI")
         mode = AMGX_mode_dFFI;
-    else if (modeStr[0] == 'h')
-        SETERRQ1(MPI_COMM_WORLD, PETSC_ERR_ARG_WRONG,
-                "CPU mode, %s, is not supported in this wrapper!",
-                modeStr.c_str());
+    else if (modeStr == "hDDI")
+        mode = AMGX_mode_hDDI;
+    else if (modeStr == "hDFI")
+        mode = AMGX_mode_hDFI;
+    else if (modeStr == "hFFI")
+        mode = AMGX_mode_hFFI;
     else
         SETERRQ1(MPI_COMM_WORLD, PETSC_ERR_ARG_WRONG,
                 "%s is not an available mode! Available modes are: "
-                "dDDI, dDFI, dFFI.\n", modeStr.c_str());
+                "dDDI, dDFI, dFFI, hDDI, hDFI, hFFI.\n", modeStr.c_str());
+
+    onHost = (modeStr[0] == 'h');
+    floatVec = (modeStr[1] == 'F');
+    floatMat = (modeStr[2] == 'F');
 
     PetscFunctionReturn(0);
 }
@@ -41,8 +47,20 @@ PetscErrorCode AmgXSolver::getIters(int &iter)
 {
     PetscFunctionBeginUser;
 
+    PetscErrorCode      ierr;
+
+    PetscInt            n;
+
+    if (hostKsp != nullptr)
+    {
+        ierr = KSPGetIterationNumber(hostKsp, &n); CHK;
+        iter = n;
+
+        PetscFunctionReturn(0);
+    }
+
     // only processes using AmgX will try to get # of iterations
-    if (gpuProc == 0)
+    if (hasAmgX)
         AMGX_solver_get_iterations_number(solver, &iter);
 
     PetscFunctionReturn(0);
@@ -54,9 +72,49 @@ PetscErrorCode AmgXSolver::getResidual(const int &iter, double &res)
 {
     PetscFunctionBeginUser;
 
+    PetscErrorCode      ierr;
+
+    // a direct solve keeps no history, only what PETSc computed last
+    if (hostKsp != nullptr)
+    {
+        ierr = KSPGetResidualNorm(hostKsp, &res); CHK;
+
+        PetscFunctionReturn(0);
+    }
+
     // only processes using AmgX will try to get residual
-    if (gpuProc == 0)
+    if (hasAmgX)
         AMGX_solver_get_iteration_residual(solver, iter, 0, &res);
 
     PetscFunctionReturn(0);
 }
+
+
+/* \implements AmgXSolver::serialFileName */
+std::string AmgXSolver::serialFileName(const std::string &file) const
+{
+    if (serial == 0) return file;
+
+    std::string             name = file;
+    std::string::size_type  dot = name.rfind(".json");
+    std::string             suffix = "." + std::to_string(serial);
+
+    if (dot == std::string::npos) name += suffix;
+    else name.insert(dot, suffix);
+
+    return name;
+}
+
+
+/* \implements AmgXSolver::mpiType */
+MPI_Datatype AmgXSolver::mpiType(const double *)
+{
+    return MPI_DOUBLE;
+}
+
+
+/* \implements AmgXSolver::mpiType */
+MPI_Datatype AmgXSolver::mpiType(const float *)
+{
+    return MPI_FLOAT;
+}
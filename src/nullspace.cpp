@@ -0,0 +1,71 @@
+/**
+ * \file nullspace.cpp
+ * \brief Definition of member functions regarding null spaces of singular
+ *        matrices.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::setNullSpace */
+PetscErrorCode AmgXSolver::setNullSpace(const MatNullSpace &ns)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (ns != nullptr)
+    {
+        ierr = PetscObjectReference((PetscObject) ns); CHK;
+    }
+
+    ierr = MatNullSpaceDestroy(&nullSpace); CHK;
+    ierr = VecDestroy(&nullRhs); CHK;
+
+    nullSpace = ns;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::projectRhs */
+PetscErrorCode AmgXSolver::projectRhs(const Vec &b, Vec &rhs)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            n,
+                        m;
+
+    // a later setA may have changed the layout
+    if (nullRhs != nullptr)
+    {
+        ierr = VecGetLocalSize(b, &n); CHK;
+        ierr = VecGetLocalSize(nullRhs, &m); CHK;
+
+        if (n != m)
+        {
+            ierr = VecDestroy(&nullRhs); CHK;
+        }
+    }
+
+    if (nullRhs == nullptr)
+    {
+        ierr = VecDuplicate(b, &nullRhs); CHK;
+    }
+
+    // the caller's b stays as it is; PETSc takes the dot products with all
+    // basis vectors in one VecMDot, so one reduction besides the constant's
+    ierr = VecCopy(b, nullRhs); CHK;
+    ierr = MatNullSpaceRemove(nullSpace, nullRhs); CHK;
+
+    rhs = nullRhs;
+
+    PetscFunctionReturn(0);
+}
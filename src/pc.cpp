@@ -0,0 +1,209 @@
+/**
+ * \file pc.cpp
+ * \brief Definition of AmgX as a PETSc preconditioner type.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// PETSc
+# include <petsc/private/pcimpl.h>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+# include "PCAMGX.hpp"
+
+
+namespace
+{
+
+/** \brief Data of a PCAMGX. */
+struct PC_AmgX
+{
+    /** \brief The solver, created by the first PCSetUp. */
+    AmgXSolver      *solver = nullptr;
+
+    /** \brief AmgX mode. */
+    std::string     mode = "dDDI";
+
+    /** \brief AmgX configuration file. */
+    std::string     config;
+};
+
+
+/** \brief Read the options of a PCAMGX. */
+PetscErrorCode readOptions(PC pc, PC_AmgX *amgx)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    const char          *prefix;
+    char                buffer[PETSC_MAX_PATH_LEN];
+    PetscBool           set;
+
+    ierr = PCGetOptionsPrefix(pc, &prefix); CHK;
+
+    ierr = PetscOptionsGetString(nullptr, prefix, "-pc_amgx_mode",
+            buffer, sizeof(buffer), &set); CHK;
+    if (set) amgx->mode = buffer;
+
+    ierr = PetscOptionsGetString(nullptr, prefix, "-pc_amgx_config",
+            buffer, sizeof(buffer), &set); CHK;
+    if (! set) SETERRQ(PetscObjectComm((PetscObject) pc), PETSC_ERR_ARG_NULL,
+            "PCAMGX requires -pc_amgx_config.\n");
+    amgx->config = buffer;
+
+    PetscFunctionReturn(0);
+}
+
+
+/** \brief Hand the preconditioning matrix to AmgX. */
+PetscErrorCode PCSetUp_AmgX(PC pc)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PC_AmgX             *amgx = (PC_AmgX*) pc->data;
+
+    if (amgx->solver == nullptr)
+    {
+        ierr = readOptions(pc, amgx); CHK;
+
+        amgx->solver = new AmgXSolver;
+        ierr = amgx->solver->initialize(PetscObjectComm((PetscObject) pc),
+                amgx->mode, amgx->config); CHK;
+        ierr = amgx->solver->setA(pc->pmat); CHK;
+    }
+    else if (pc->flag == SAME_NONZERO_PATTERN)
+    {
+        ierr = amgx->solver->updateA(pc->pmat); CHK;
+    }
+    else
+    {
+        ierr = amgx->solver->setA(pc->pmat); CHK;
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/** \brief Apply the preconditioner: y = M^{-1} x. */
+PetscErrorCode PCApply_AmgX(PC pc, Vec x, Vec y)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PC_AmgX             *amgx = (PC_AmgX*) pc->data;
+
+    AmgXSolver::SolveReport     report;
+
+    ierr = VecSet(y, 0.0); CHK;
+
+    // a fixed number of cycles does not converge in the sense of AmgX, so
+    // only a failure is an error here
+    ierr = amgx->solver->solve(y, x, report); CHK;
+
+    if (report.status == AMGX_SOLVE_FAILED)
+        SETERRQ(PetscObjectComm((PetscObject) pc), PETSC_ERR_LIB,
+                "AmgX failed to apply the preconditioner.\n");
+
+    PetscFunctionReturn(0);
+}
+
+
+/** \brief Release AmgX, e.g., before the operators change size. */
+PetscErrorCode PCReset_AmgX(PC pc)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PC_AmgX             *amgx = (PC_AmgX*) pc->data;
+
+    if (amgx->solver != nullptr)
+    {
+        ierr = amgx->solver->finalize(); CHK;
+        delete amgx->solver;
+        amgx->solver = nullptr;
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/** \brief Destroy a PCAMGX. */
+PetscErrorCode PCDestroy_AmgX(PC pc)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = PCReset_AmgX(pc); CHK;
+
+    delete (PC_AmgX*) pc->data;
+    pc->data = nullptr;
+
+    PetscFunctionReturn(0);
+}
+
+
+/** \brief Print the mode and the configuration file. */
+PetscErrorCode PCView_AmgX(PC pc, PetscViewer viewer)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PC_AmgX             *amgx = (PC_AmgX*) pc->data;
+
+    PetscBool           isAscii;
+
+    ierr = PetscObjectTypeCompare(
+            (PetscObject) viewer, PETSCVIEWERASCII, &isAscii); CHK;
+
+    if (isAscii)
+    {
+        ierr = PetscViewerASCIIPrintf(viewer,
+                "  AmgX mode: %s\n", amgx->mode.c_str()); CHK;
+        ierr = PetscViewerASCIIPrintf(viewer,
+                "  AmgX configuration: %s\n", amgx->config.c_str()); CHK;
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/** \brief Create a PCAMGX; called by PCSetType. */
+PetscErrorCode PCCreate_AmgX(PC pc)
+{
+    PetscFunctionBeginUser;
+
+    pc->data = new PC_AmgX;
+
+    pc->ops->setup = PCSetUp_AmgX;
+    pc->ops->apply = PCApply_AmgX;
+    pc->ops->reset = PCReset_AmgX;
+    pc->ops->destroy = PCDestroy_AmgX;
+    pc->ops->view = PCView_AmgX;
+
+    PetscFunctionReturn(0);
+}
+
+} // end of anonymous namespace
+
+
+// definition of PCAmgXRegister
+PetscErrorCode PCAmgXRegister()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = PCRegister(PCAMGX, PCCreate_AmgX); CHK;
+
+    PetscFunctionReturn(0);
+}
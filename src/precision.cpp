@@ -0,0 +1,75 @@
+/**
+ * \file precision.cpp
+ * \brief Definition of member functions regarding the precision AmgX reads
+ *        values in.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::narrow */
+PetscErrorCode AmgXSolver::narrow(const PetscScalar *src, const PetscInt n,
+        std::vector<float> &dst)
+{
+    PetscFunctionBeginUser;
+
+    std::vector<PetscScalar>    buffer;
+
+    if (! onHost && isDevicePtr(src))
+    {
+        buffer.resize(n);
+        CHECK(cudaMemcpyAsync(buffer.data(), src, sizeof(PetscScalar) * n,
+                    cudaMemcpyDeviceToHost, stream));
+        CHECK(cudaStreamSynchronize(stream));
+        src = buffer.data();
+    }
+
+    dst.assign(src, src + n);
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::matValues */
+PetscErrorCode AmgXSolver::matValues(const PetscScalar *values,
+        const PetscInt n, std::vector<float> &buffer, const void *&data)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    data = values;
+
+    if (! floatMat) PetscFunctionReturn(0);
+
+    ierr = narrow(values, n, buffer); CHK;
+    data = buffer.data();
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::matValues */
+PetscErrorCode AmgXSolver::matValues(const float *values,
+        const PetscInt /* n */, std::vector<float> & /* buffer */,
+        const void *&data)
+{
+    PetscFunctionBeginUser;
+
+    // float values are only taken in modes with a float matrix
+    data = values;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::matBytes */
+size_t AmgXSolver::matBytes() const
+{
+    return floatMat ? sizeof(float) : sizeof(PetscScalar);
+}
@@ -0,0 +1,121 @@
+/**
+ * \file prewarm.cpp
+ * \brief Definition of member functions regarding prewarming AmgX.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <numeric>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::prewarm */
+PetscErrorCode AmgXSolver::prewarm()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            rows = 0;
+
+    ierr = PetscOptionsGetInt(nullptr, nullptr,
+            "-amgx_prewarm", &rows, nullptr); CHK;
+
+    if (rows < 0)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_OUTOFRANGE,
+                "-amgx_prewarm needs a non-negative number of rows.\n");
+
+    if (rows == 0 || gpuWorld == MPI_COMM_NULL) PetscFunctionReturn(0);
+
+    ierr = startAmgX(); CHK;
+
+    // the device of this process also gets the rows of its devWorld
+    PetscInt                    nLocalRows = rows * devWorldSize;
+
+    PetscInt64                  nRows = nLocalRows;
+
+    std::vector<PetscInt64>     offsets(gpuWorldSize + 1, 0);
+
+    std::vector<PetscInt>       row(nLocalRows + 1, 0);
+
+    std::vector<PetscInt64>     col;
+
+    std::vector<PetscScalar>    data,
+                                rhs(nLocalRows, 1.0),
+                                unks(nLocalRows, 0.0);
+
+    std::vector<float>          narrowed,
+                                rhsF(nLocalRows, 1.0),
+                                unksF(nLocalRows, 0.0);
+
+    const void                  *values;
+
+    ierr = MPI_Allgather(&nRows, 1, MPIU_INT64,
+            &offsets[1], 1, MPIU_INT64, gpuWorld); CHK;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    // one chain through all processes, so there are halos to build as well
+    const PetscInt64    first = offsets[myGpuWorldRank],
+                        nGlobalRows = offsets[gpuWorldSize];
+
+    col.reserve(3 * nLocalRows);
+    data.reserve(3 * nLocalRows);
+
+    for (PetscInt i = 0; i < nLocalRows; ++i)
+    {
+        const PetscInt64    g = first + i;
+
+        if (g > 0) { col.push_back(g - 1); data.push_back(-1.0); }
+        col.push_back(g); data.push_back(2.0);
+        if (g + 1 < nGlobalRows) { col.push_back(g + 1); data.push_back(-1.0); }
+
+        row[i + 1] = col.size();
+    }
+
+    // nobody asked for the grid statistics and residuals of this system
+    printMuted = true;
+
+    ierr = matValues(data.data(), data.size(), narrowed, values); CHK;
+
+    AMGX_distribution_handle dist;
+    AMGX_distribution_create(&dist, cfg);
+    AMGX_distribution_set_partition_data(
+            dist, AMGX_DIST_PARTITION_OFFSETS, offsets.data());
+
+    AMGX_matrix_upload_distributed(
+            AmgXA, nGlobalRows, nLocalRows, row[nLocalRows],
+            1, 1, row.data(), col.data(), values,
+            nullptr, dist);
+    AMGX_distribution_destroy(dist);
+
+    AMGX_solver_setup(solver, AmgXA);
+
+    AMGX_vector_bind(AmgXP, AmgXA);
+    AMGX_vector_bind(AmgXRHS, AmgXA);
+
+    // AmgX reads the vectors as float in dFFI and hFFI
+    if (floatVec)
+    {
+        AMGX_vector_upload(AmgXP, nLocalRows, 1, unksF.data());
+        AMGX_vector_upload(AmgXRHS, nLocalRows, 1, rhsF.data());
+    }
+    else
+    {
+        AMGX_vector_upload(AmgXP, nLocalRows, 1, unks.data());
+        AMGX_vector_upload(AmgXRHS, nLocalRows, 1, rhs.data());
+    }
+
+    AMGX_solver_solve(solver, AmgXRHS, AmgXP);
+
+    if (floatVec) AMGX_vector_download(AmgXP, unksF.data());
+    else AMGX_vector_download(AmgXP, unks.data());
+
+    printMuted = false;
+
+    PetscFunctionReturn(0);
+}
@@ -0,0 +1,507 @@
+/**
+ * \file record.cpp
+ * \brief Definition of member functions recording the calls to AmgXSolver.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <cstring>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+# include "AmgXRecord.hpp"
+
+
+/* \implements AmgXSolver::initRecord */
+PetscErrorCode AmgXSolver::initRecord(
+        const std::string &modeStr, const std::string &cfgFile)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    char                file[PETSC_MAX_PATH_LEN];
+    PetscBool           set;
+
+    int                 opened;
+
+    AmgXRecord::Header  header;
+
+    ierr = PetscOptionsGetString(nullptr, nullptr,
+            "-amgx_record", file, sizeof(file), &set); CHK;
+
+    if (! set) PetscFunctionReturn(0);
+
+    std::string     name =
+        serialFileName(file) + "." + std::to_string(myGlobalRank);
+
+    recordFp = std::fopen(name.c_str(), "wb");
+
+    // fail on all ranks together, or the collectives in setA would hang
+    opened = (recordFp != nullptr);
+    ierr = MPI_Allreduce(MPI_IN_PLACE, &opened, 1, MPI_INT,
+            MPI_MIN, globalCpuWorld); CHK;
+
+    if (! opened)
+    {
+        if (recordFp != nullptr) std::fclose(recordFp);
+        recordFp = nullptr;
+
+        SETERRQ1(globalCpuWorld, PETSC_ERR_FILE_OPEN,
+                "Can not open record files %s.<rank>.\n",
+                serialFileName(file).c_str());
+    }
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, AmgXRecord::magic, sizeof(header.magic));
+    header.version = AmgXRecord::version;
+    header.rank = myGlobalRank;
+    header.size = globalSize;
+    header.intSize = sizeof(PetscInt);
+    header.scalarSize = sizeof(PetscScalar);
+    std::strncpy(header.mode, modeStr.c_str(), sizeof(header.mode) - 1);
+    std::strncpy(header.config, cfgFile.c_str(), sizeof(header.config) - 1);
+
+    ierr = recordData(&header, sizeof(header)); CHK;
+
+    recordValues.clear();
+
+    // a common time origin, as in initTrace
+    ierr = MPI_Barrier(globalCpuWorld); CHK;
+    recordOrigin = MPI_Wtime();
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::closeRecord */
+PetscErrorCode AmgXSolver::closeRecord()
+{
+    PetscFunctionBeginUser;
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    int     err = std::fclose(recordFp);
+
+    recordFp = nullptr;
+    recordValues.clear();
+    recordGuess.clear();
+
+    if (err != 0) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE,
+            "Can not finish writing the record file.\n");
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordEntry */
+PetscErrorCode AmgXSolver::recordEntry(const int kind, const bool onDevice,
+        const double begin, const double end)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    AmgXRecord::Entry   entry;
+
+    entry.kind = kind;
+    entry.onDevice = onDevice;
+    entry.begin = begin - recordOrigin;
+    entry.end = end - recordOrigin;
+
+    ierr = recordData(&entry, sizeof(entry)); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordData */
+PetscErrorCode AmgXSolver::recordData(const void *ptr, const size_t bytes)
+{
+    PetscFunctionBeginUser;
+
+    std::vector<char>   buffer;
+
+    if (bytes == 0) PetscFunctionReturn(0);
+
+    if (! onHost && isDevicePtr(ptr))
+    {
+        buffer.resize(bytes);
+        CHECK(cudaMemcpyAsync(buffer.data(), ptr, bytes,
+                    cudaMemcpyDeviceToHost, stream));
+        CHECK(cudaStreamSynchronize(stream));
+        ptr = buffer.data();
+    }
+
+    if (std::fwrite(ptr, 1, bytes, recordFp) != bytes)
+        SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE,
+                "Can not write to the record file.\n");
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordSetA */
+PetscErrorCode AmgXSolver::recordSetA(const Mat &A, const double begin)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            nGlobalRows,
+                        bg,
+                        ed;
+
+    std::vector<PetscInt>       row(1, 0),
+                                col;
+    std::vector<PetscScalar>    val;
+
+    const double        end = MPI_Wtime();
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    ierr = MatGetSize(A, &nGlobalRows, nullptr); CHK;
+    ierr = MatGetOwnershipRange(A, &bg, &ed); CHK;
+
+    // rows as the application owns them, not as redistributed for AmgX
+    for (PetscInt r = bg; r < ed; ++r)
+    {
+        PetscInt            n;
+        const PetscInt      *cols;
+        const PetscScalar   *vals;
+
+        ierr = MatGetRow(A, r, &n, &cols, &vals); CHK;
+        col.insert(col.end(), cols, cols + n);
+        val.insert(val.end(), vals, vals + n);
+        row.push_back(col.size());
+        ierr = MatRestoreRow(A, r, &n, &cols, &vals); CHK;
+    }
+
+    PetscInt            sizes[4] = {nGlobalRows, ed - bg,
+                                    (PetscInt) col.size(), 0};
+
+    ierr = recordEntry(AmgXRecord::SetAMat, false, begin, end); CHK;
+    ierr = recordData(sizes, sizeof(sizes)); CHK;
+    ierr = recordData(row.data(), sizeof(PetscInt) * row.size()); CHK;
+    ierr = recordData(col.data(), sizeof(PetscInt) * col.size()); CHK;
+    ierr = recordData(val.data(), sizeof(PetscScalar) * val.size()); CHK;
+
+    recordValues.swap(val);
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordSetA */
+PetscErrorCode AmgXSolver::recordSetA(const PetscInt nGlobalRows,
+        const PetscInt nLocalRows, const PetscInt nLocalNz,
+        const PetscInt *rowOffsets, const PetscInt *colIndicesGlobal,
+        const PetscScalar *values, const PetscInt *partData,
+        const double begin)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    const double        end = MPI_Wtime();
+
+    PetscInt            sizes[4] = {nGlobalRows, nLocalRows, nLocalNz,
+                                    partData != nullptr};
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    ierr = recordEntry(AmgXRecord::SetARaw,
+            ! onHost && isDevicePtr(values), begin, end); CHK;
+    ierr = recordData(sizes, sizeof(sizes)); CHK;
+    ierr = recordData(rowOffsets, sizeof(PetscInt) * (nLocalRows + 1)); CHK;
+    ierr = recordData(colIndicesGlobal, sizeof(PetscInt) * nLocalNz); CHK;
+    ierr = recordData(values, sizeof(PetscScalar) * nLocalNz); CHK;
+
+    if (partData != nullptr)
+    {
+        ierr = recordData(partData, sizeof(PetscInt) * nGlobalRows); CHK;
+    }
+
+    // keep a host copy to compare the next updateA with
+    recordValues.resize(nLocalNz);
+    if (! onHost && isDevicePtr(values))
+    {
+        CHECK(cudaMemcpyAsync(recordValues.data(), values,
+                    sizeof(PetscScalar) * nLocalNz,
+                    cudaMemcpyDeviceToHost, stream));
+        CHECK(cudaStreamSynchronize(stream));
+    }
+    else
+    {
+        recordValues.assign(values, values + nLocalNz);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordUpdateA */
+PetscErrorCode AmgXSolver::recordUpdateA(const PetscInt nLocalRows,
+        const PetscInt nLocalNz, const PetscScalar *values,
+        const double begin)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    std::vector<PetscScalar>    current;
+
+    const double        end = MPI_Wtime();
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    const bool          onDevice = ! onHost && isDevicePtr(values);
+
+    current.resize(nLocalNz);
+    if (onDevice)
+    {
+        CHECK(cudaMemcpyAsync(current.data(), values,
+                    sizeof(PetscScalar) * nLocalNz,
+                    cudaMemcpyDeviceToHost, stream));
+        CHECK(cudaStreamSynchronize(stream));
+    }
+    else
+    {
+        current.assign(values, values + nLocalNz);
+    }
+
+    ierr = recordDelta(AmgXRecord::UpdateA,
+            onDevice, nLocalRows, current, begin, end); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordUpdateA */
+PetscErrorCode AmgXSolver::recordUpdateA(const PetscInt nLocalRows,
+        const PetscInt nLocalNz, const float *values,
+        const double begin)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    std::vector<PetscScalar>    current;
+
+    const double        end = MPI_Wtime();
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    const bool          onDevice = ! onHost && isDevicePtr(values);
+
+    ierr = widen(values, nLocalNz, current); CHK;
+
+    ierr = recordDelta(AmgXRecord::UpdateAFloat,
+            onDevice, nLocalRows, current, begin, end); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordUpdateA */
+PetscErrorCode AmgXSolver::recordUpdateA(const Mat &A, const double begin)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            bg,
+                        ed;
+
+    std::vector<PetscScalar>    current;
+
+    const double        end = MPI_Wtime();
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    ierr = MatGetOwnershipRange(A, &bg, &ed); CHK;
+
+    // the same order as in recordSetA, so deltas line up with its values
+    current.reserve(recordValues.size());
+    for (PetscInt r = bg; r < ed; ++r)
+    {
+        PetscInt            n;
+        const PetscScalar   *vals;
+
+        ierr = MatGetRow(A, r, &n, nullptr, &vals); CHK;
+        current.insert(current.end(), vals, vals + n);
+        ierr = MatRestoreRow(A, r, &n, nullptr, &vals); CHK;
+    }
+
+    ierr = recordDelta(AmgXRecord::UpdateAMat,
+            false, ed - bg, current, begin, end); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordDelta */
+PetscErrorCode AmgXSolver::recordDelta(const int kind, const bool onDevice,
+        const PetscInt nLocalRows, std::vector<PetscScalar> &current,
+        const double begin, const double end)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    std::vector<PetscInt>       pos;
+    std::vector<PetscScalar>    val;
+
+    const PetscInt      nLocalNz = current.size();
+
+    // a delta only pays off when less than about half of the values changed
+    bool    delta = ((PetscInt) recordValues.size() == nLocalNz);
+
+    for (PetscInt i = 0; delta && i < nLocalNz; ++i)
+    {
+        if (current[i] == recordValues[i]) continue;
+
+        pos.push_back(i);
+        val.push_back(current[i]);
+
+        delta = (pos.size() * (sizeof(PetscInt) + sizeof(PetscScalar)) <
+                nLocalNz * sizeof(PetscScalar));
+    }
+
+    PetscInt    sizes[3] = {nLocalRows, nLocalNz,
+                            delta ? (PetscInt) pos.size() : -1};
+
+    ierr = recordEntry(kind, onDevice, begin, end); CHK;
+    ierr = recordData(sizes, sizeof(sizes)); CHK;
+
+    if (delta)
+    {
+        ierr = recordData(pos.data(), sizeof(PetscInt) * pos.size()); CHK;
+        ierr = recordData(val.data(), sizeof(PetscScalar) * val.size()); CHK;
+    }
+    else
+    {
+        ierr = recordData(current.data(), sizeof(PetscScalar) * nLocalNz); CHK;
+    }
+
+    recordValues.swap(current);
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::keepGuess */
+PetscErrorCode AmgXSolver::keepGuess(const PetscScalar *p, const int nRows)
+{
+    PetscFunctionBeginUser;
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    recordGuess.resize(nRows);
+
+    if (! onHost && isDevicePtr(p))
+    {
+        CHECK(cudaMemcpyAsync(recordGuess.data(), p,
+                    sizeof(PetscScalar) * nRows,
+                    cudaMemcpyDeviceToHost, stream));
+        CHECK(cudaStreamSynchronize(stream));
+    }
+    else
+    {
+        recordGuess.assign(p, p + nRows);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordSolveCall */
+PetscErrorCode AmgXSolver::recordSolveCall(const int kind,
+        const PetscScalar *b, const int nRows, const double begin)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            n = nRows;
+
+    const double        end = MPI_Wtime();
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    ierr = recordEntry(kind, ! onHost && isDevicePtr(b), begin, end); CHK;
+    ierr = recordData(&n, sizeof(n)); CHK;
+    ierr = recordData(recordGuess.data(), sizeof(PetscScalar) * nRows); CHK;
+    ierr = recordData(b, sizeof(PetscScalar) * nRows); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::keepGuess */
+PetscErrorCode AmgXSolver::keepGuess(const float *p, const int nRows)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    ierr = widen(p, nRows, recordGuess); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::recordSolveCall */
+PetscErrorCode AmgXSolver::recordSolveCall(const int kind,
+        const float *b, const int nRows, const double begin)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            n = nRows;
+
+    std::vector<PetscScalar>    wide;
+
+    const double        end = MPI_Wtime();
+
+    if (recordFp == nullptr) PetscFunctionReturn(0);
+
+    ierr = recordEntry(kind, ! onHost && isDevicePtr(b), begin, end); CHK;
+
+    ierr = widen(b, nRows, wide); CHK;
+
+    ierr = recordData(&n, sizeof(n)); CHK;
+    ierr = recordData(recordGuess.data(), sizeof(PetscScalar) * nRows); CHK;
+    ierr = recordData(wide.data(), sizeof(PetscScalar) * nRows); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::widen */
+PetscErrorCode AmgXSolver::widen(const float *src, const PetscInt n,
+        std::vector<PetscScalar> &dst)
+{
+    PetscFunctionBeginUser;
+
+    std::vector<float>  buffer;
+
+    if (! onHost && isDevicePtr(src))
+    {
+        buffer.resize(n);
+        CHECK(cudaMemcpyAsync(buffer.data(), src, sizeof(float) * n,
+                    cudaMemcpyDeviceToHost, stream));
+        CHECK(cudaStreamSynchronize(stream));
+        src = buffer.data();
+    }
+
+    dst.assign(src, src + n);
+
+    PetscFunctionReturn(0);
+}
@@ -0,0 +1,122 @@
+/**
+ * \file resources.cpp
+ * \brief Definition of member functions regarding shared AmgX resources.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <algorithm>
+# include <limits>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::acquireResources */
+PetscErrorCode AmgXSolver::acquireResources()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    int                 size;
+
+    MPI_Group           group,
+                        world;
+
+    std::vector<int>    ranks;
+
+    // the key: processes of gpuWorld, by their ranks in MPI_COMM_WORLD, and
+    // the device of this process
+    ierr = MPI_Comm_size(gpuWorld, &size); CHK;
+    ierr = MPI_Comm_group(gpuWorld, &group); CHK;
+    ierr = MPI_Comm_group(MPI_COMM_WORLD, &world); CHK;
+
+    std::vector<int>    local(size);
+    for (int i = 0; i < size; ++i) local[i] = i;
+
+    ranks.resize(size);
+    ierr = MPI_Group_translate_ranks(
+            group, size, local.data(), world, ranks.data()); CHK;
+
+    ierr = MPI_Group_free(&group); CHK;
+    ierr = MPI_Group_free(&world); CHK;
+
+    // the oldest matching entry; all processes must pick the same one, or
+    // none of them shares
+    int     tags[2] = {std::numeric_limits<int>::max(), 0};
+
+    // with -amgx_thread_safe, an instance does not share in either direction
+    if (! threadSafe)
+        for (const SharedRsrc &e: registry)
+            if (! e.exclusive && e.ranks == ranks && e.devID == devID)
+            {
+                tags[0] = e.tag;
+                break;
+            }
+
+    tags[1] = -tags[0];
+    ierr = MPI_Allreduce(MPI_IN_PLACE, tags, 2, MPI_INT, MPI_MIN, gpuWorld);
+    CHK;
+
+    if (tags[0] != std::numeric_limits<int>::max() && tags[0] == -tags[1])
+    {
+        auto    it = std::find_if(registry.begin(), registry.end(),
+                [&tags](const SharedRsrc &e) { return e.tag == tags[0]; });
+
+        it->users += 1;
+        rsrc = it->rsrc;
+
+        PetscFunctionReturn(0);
+    }
+
+    // a new entry, with a tag none of the processes has used
+    SharedRsrc      e;
+
+    e.ranks = std::move(ranks);
+    e.devID = devID;
+    e.exclusive = threadSafe;
+
+    for (const SharedRsrc &o: registry) e.tag = std::max(e.tag, o.tag + 1);
+    ierr = MPI_Allreduce(MPI_IN_PLACE, &e.tag, 1, MPI_INT, MPI_MAX, gpuWorld);
+    CHK;
+
+    // gpuWorld goes with this instance, while the resources may not
+    ierr = MPI_Comm_dup(gpuWorld, &e.comm); CHK;
+    AMGX_resources_create(&e.rsrc, cfg, &e.comm, 1, &devID);
+
+    rsrc = e.rsrc;
+    registry.push_back(std::move(e));
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::releaseResources */
+PetscErrorCode AmgXSolver::releaseResources()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    auto    it = std::find_if(registry.begin(), registry.end(),
+            [this](const SharedRsrc &e) { return e.rsrc == rsrc; });
+
+    rsrc = nullptr;
+
+    if (it == registry.end()) PetscFunctionReturn(0);
+
+    it->users -= 1;
+
+    if (it->users == 0)
+    {
+        AMGX_resources_destroy(it->rsrc);
+        ierr = MPI_Comm_free(&it->comm); CHK;
+        registry.erase(it);
+    }
+
+    PetscFunctionReturn(0);
+}
@@ -0,0 +1,133 @@
+/**
+ * \file reuse.cpp
+ * \brief Definition of member functions regarding the reuse of hierarchies.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::initReuse */
+PetscErrorCode AmgXSolver::initReuse()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    reuseRatio = 0.0;
+    reuseMaxIters = 0;
+
+    ierr = PetscOptionsGetReal(nullptr, nullptr,
+            "-amgx_reuse_ratio", &reuseRatio, nullptr); CHK;
+    ierr = PetscOptionsGetInt(nullptr, nullptr,
+            "-amgx_reuse_max_iters", &reuseMaxIters, nullptr); CHK;
+
+    if (reuseRatio < 0.0 || reuseMaxIters < 0)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_OUTOFRANGE,
+                "-amgx_reuse_ratio and -amgx_reuse_max_iters "
+                "can not be negative.\n");
+
+    ierr = resetReuse(); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::resetReuse */
+PetscErrorCode AmgXSolver::resetReuse()
+{
+    PetscFunctionBeginUser;
+
+    reuseBaseline = -1;
+    reuseStale = false;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::keepHierarchy */
+bool AmgXSolver::keepHierarchy()
+{
+    if (reuseRatio == 0.0 && reuseMaxIters == 0) return false;
+
+    // only the fine level now has the new values
+    reuseStale = true;
+
+    return true;
+}
+
+
+/* \implements AmgXSolver::checkReuse */
+PetscErrorCode AmgXSolver::checkReuse()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            iters = 0;
+
+    std::string         gridStats;
+
+    if (reuseRatio == 0.0 && reuseMaxIters == 0) PetscFunctionReturn(0);
+
+    // a direct solve on the host has no hierarchy to rebuild
+    if (hostKsp != nullptr) PetscFunctionReturn(0);
+
+    double              tic = MPI_Wtime();
+
+    // the rank 0 of globalCpuWorld is always in gpuWorld
+    if (outerKsp != nullptr)
+    {
+        ierr = KSPGetIterationNumber(outerKsp, &iters); CHK;
+    }
+    else
+    {
+        int     n = 0;
+
+        if (myGlobalRank == 0) AMGX_solver_get_iterations_number(solver, &n);
+
+        ierr = MPI_Bcast(&n, 1, MPI_INT, 0, globalCpuWorld); CHK;
+        iters = n;
+    }
+
+    // the first solve after a full setup sets the baseline
+    if (reuseBaseline < 0)
+    {
+        reuseBaseline = iters;
+        PetscFunctionReturn(0);
+    }
+
+    if (! ((reuseRatio > 0.0 && iters > reuseRatio * reuseBaseline) ||
+                (reuseMaxIters > 0 && iters > reuseMaxIters)))
+        PetscFunctionReturn(0);
+
+    // coarse levels built from old values go first; if the hierarchy is
+    // already up to date with the values, its structure is what hurts
+    const bool  resetup = reuseStale;
+
+    if (gpuWorld != MPI_COMM_NULL)
+    {
+        ierr = barrier(gpuWorld); CHK;
+        ierr = setupSolver(resetup, gridStats); CHK;
+    }
+    ierr = barrier(globalCpuWorld); CHK;
+
+    ierr = parseGridStats(gridStats); CHK;
+
+    if (resetup)
+    {
+        reuseStale = false;
+    }
+    else
+    {
+        ierr = resetReuse(); CHK;
+    }
+
+    addSample(resetup ? StResetup : StSetup, MPI_Wtime() - tic);
+
+    PetscFunctionReturn(0);
+}
@@ -24,6 +24,52 @@ PetscErrorCode AmgXSolver::setA(const Mat &A)
 
     PetscErrorCode      ierr;
 
+    bool                done;
+
+    // small systems do not go to AmgX at all
+    ierr = setHost(A, done); CHK;
+    if (done) PetscFunctionReturn(0);
+
+    ierr = setA_mat(A, 0.0, needsOuter(A, A, 0.0)); CHK;
+    ierr = setOperator(A, A); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::setA */
+PetscErrorCode AmgXSolver::setA(const Mat &A, const Mat &P)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscReal           tol = 0.0;
+
+    bool                done;
+
+    // a direct solve of a small A needs no P
+    ierr = setHost(A, done); CHK;
+    if (done) PetscFunctionReturn(0);
+
+    ierr = PetscOptionsGetReal(nullptr, nullptr,
+            "-amgx_drop_tol", &tol, nullptr); CHK;
+
+    ierr = setA_mat(P, tol, needsOuter(A, P, tol)); CHK;
+    ierr = setOperator(A, P); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::setA_mat */
+PetscErrorCode AmgXSolver::setA_mat(const Mat &A, const PetscReal tol,
+        const bool outer)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
     Mat                 localA;
 
     IS                  devIS;
@@ -36,11 +82,33 @@ PetscErrorCode AmgXSolver::setA(const Mat &A)
     std::vector<PetscInt64>     col;
     std::vector<PetscScalar>    data;
     std::vector<PetscInt>       partData;
+    std::vector<float>          narrowed;
 
+    const void          *values;
+
+    std::string         gridStats;
+
+    bool                changed;
+
+    double              tic = MPI_Wtime();
+
+
+    // the calling thread may not have used the device of this process yet
+    ierr = bindDevice(); CHK;
+
+    // the first matrix of this instance creates its AmgX objects
+    ierr = startAmgX(); CHK;
 
     // get number of rows in global matrix
     ierr = MatGetSize(A, &nGlobalRows, nullptr); CHK;
 
+    // a new matrix may be distributed differently from the last one
+    ierr = ISDestroy(&lastDevIS); CHK;
+    ierr = VecScatterDestroy(&scatterLhs); CHK;
+    ierr = VecScatterDestroy(&scatterRhs); CHK;
+    ierr = VecDestroy(&redistLhs); CHK;
+    ierr = VecDestroy(&redistRhs); CHK;
+
     // get the row indices of redistributed matrix owned by processes in gpuWorld
     ierr = getDevIS(A, devIS); CHK;
 
@@ -53,6 +121,14 @@ PetscErrorCode AmgXSolver::setA(const Mat &A)
     // destroy local matrix
     ierr = destroyLocalA(A, localA); CHK;
 
+    // sparsify the matrix the hierarchy is built from, if asked to
+    dropTol = tol;
+    keptNz.clear();
+    if (dropTol > 0.0)
+    {
+        ierr = dropSmall(devIS, dropTol, row, col, data); CHK;
+    }
+
     // get a partition vector required by AmgX
     ierr = getPartData(devIS, nGlobalRows, partData, usesOffsets); CHK;
 
@@ -60,10 +136,14 @@ PetscErrorCode AmgXSolver::setA(const Mat &A)
     // upload matrix A to AmgX
     if (gpuWorld != MPI_COMM_NULL)
     {
-        ierr = MPI_Barrier(gpuWorld); CHK;
+        ierr = barrier(gpuWorld); CHK;
         // offsets need to be 64 bit, since we use 64 bit column indices
         std::vector<PetscInt64> offsets;
 
+        ierr = eventBegin(EvUploadA); CHK;
+
+        ierr = matValues(data.data(), data.size(), narrowed, values); CHK;
+
         AMGX_distribution_handle dist;
         AMGX_distribution_create(&dist, cfg);
         if (usesOffsets) {
@@ -75,22 +155,131 @@ PetscErrorCode AmgXSolver::setA(const Mat &A)
 
         AMGX_matrix_upload_distributed(
                 AmgXA, nGlobalRows, nLocalRows, row[nLocalRows],
-                1, 1, row.data(), col.data(), data.data(),
+                1, 1, row.data(), col.data(), values,
                 nullptr, dist);
         AMGX_distribution_destroy(dist);
 
+        ierr = logCpuToGpu(values,
+                sizeof(PetscInt) * row.size() + sizeof(PetscInt64) * col.size()
+                + matBytes() * data.size()); CHK;
+        ierr = eventEnd(EvUploadA); CHK;
+
+        // the stopping criteria of setTolerance and setMaxIters go to AmgX
+        // only if it owns the solves; the setup below covers a new solver
+        ierr = stopAmgX(outer, changed); CHK;
+
         // bind the matrix A to the solver
-        ierr = MPI_Barrier(gpuWorld); CHK;
-        AMGX_solver_setup(solver, AmgXA);
+        ierr = barrier(gpuWorld); CHK;
+        ierr = setupSolver(false, gridStats); CHK;
 
         // connect (bind) vectors to the matrix
         AMGX_vector_bind(AmgXP, AmgXA);
         AMGX_vector_bind(AmgXRHS, AmgXA);
     }
-    ierr = MPI_Barrier(globalCpuWorld); CHK;
+    ierr = barrier(globalCpuWorld); CHK;
 
-    // destroy temporary PETSc objects
-    ierr = ISDestroy(&devIS); CHK;
+    // get statistics of the new hierarchy
+    ierr = parseGridStats(gridStats); CHK;
+    ierr = resetReuse(); CHK;
+
+    // keep the redistributed rows for updateA
+    lastDevIS = devIS;
+    hasA = true;
+
+    addSample(StSetup, MPI_Wtime() - tic);
+
+    ierr = recordSetA(A, tic); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::initRefine */
+PetscErrorCode AmgXSolver::initRefine()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    refine = PETSC_FALSE;
+
+    ierr = PetscOptionsGetBool(nullptr, nullptr,
+            "-amgx_refine", &refine, nullptr); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::needsOuter */
+bool AmgXSolver::needsOuter(
+        const Mat &A, const Mat &P, const PetscReal tol) const
+{
+    return A != P || tol > 0.0 || refine;
+}
+
+
+/* \implements AmgXSolver::setOperator */
+PetscErrorCode AmgXSolver::setOperator(const Mat &A, const Mat &P)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PC                  pc;
+
+    if (! needsOuter(A, P, dropTol))
+    {
+        ierr = KSPDestroy(&outerKsp); CHK;
+
+        // AmgX owns the solves again, e.g., after updateA(A, A)
+        ierr = applyStopping(); CHK;
+
+        PetscFunctionReturn(0);
+    }
+
+    // AmgX binds its Krylov solver and its AMG to one matrix, so a PETSc
+    // Krylov solver applies A and calls AmgX on the (sparsified) P as its
+    // preconditioner; with -amgx_refine, it is a Richardson iteration whose
+    // residuals are in the precision of PETSc, and each AmgX solve is a
+    // correction in the precision of the mode
+    if (outerKsp != nullptr && outerRefine != refine)
+    {
+        ierr = KSPDestroy(&outerKsp); CHK;
+    }
+
+    if (outerKsp == nullptr)
+    {
+        ierr = KSPCreate(PetscObjectComm((PetscObject) A), &outerKsp); CHK;
+        ierr = KSPSetOptionsPrefix(outerKsp, "amgx_"); CHK;
+
+        if (refine)
+        {
+            ierr = KSPSetType(outerKsp, KSPRICHARDSON); CHK;
+            ierr = KSPSetNormType(
+                    outerKsp, KSP_NORM_UNPRECONDITIONED); CHK;
+        }
+        else
+        {
+            ierr = KSPSetType(outerKsp, KSPFGMRES); CHK;
+        }
+
+        ierr = KSPSetInitialGuessNonzero(outerKsp, PETSC_TRUE); CHK;
+
+        ierr = KSPGetPC(outerKsp, &pc); CHK;
+        ierr = PCSetType(pc, PCSHELL); CHK;
+        ierr = PCShellSetContext(pc, this); CHK;
+        ierr = PCShellSetApply(pc, applyOuterPC); CHK;
+        ierr = PCShellSetName(pc, "AmgX"); CHK;
+
+        ierr = KSPSetFromOptions(outerKsp); CHK;
+        outerRefine = refine;
+
+        // the stopping criteria of solve are now those of this KSP, and
+        // AmgX drops them if it had them
+        ierr = applyStopping(); CHK;
+    }
+
+    ierr = KSPSetOperators(outerKsp, A, A); CHK;
 
     PetscFunctionReturn(0);
 }
@@ -104,6 +293,8 @@ PetscErrorCode AmgXSolver::getDevIS(const Mat &A, IS &devIS)
     PetscErrorCode      ierr;
     IS                  tempIS;
 
+    ierr = eventBegin(EvGetDevIS); CHK;
+
     // get index sets of A locally owned by each process
     // note that devIS is now a serial IS on each process
     ierr = MatGetOwnershipIS(A, &devIS, nullptr); CHK;
@@ -126,6 +317,8 @@ PetscErrorCode AmgXSolver::getDevIS(const Mat &A, IS &devIS)
     // devIS is not guaranteed to be sorted. We sort it here.
     ierr = ISSort(devIS); CHK;
 
+    ierr = eventEnd(EvGetDevIS); CHK;
+
     PetscFunctionReturn(0);
 }
 
@@ -184,6 +377,8 @@ PetscErrorCode AmgXSolver::redistMat(const Mat &A, const IS &devIS, Mat &newA)
 
     PetscErrorCode      ierr;
 
+    ierr = eventBegin(EvRedistMat); CHK;
+
     if (gpuWorldSize == globalSize) // no redistributation required
     {
         newA = A;
@@ -198,13 +393,19 @@ PetscErrorCode AmgXSolver::redistMat(const Mat &A, const IS &devIS, Mat &newA)
         // redistribute the matrix A to newA
         ierr = MatGetSubMatrix(A, is, is, MAT_INITIAL_MATRIX, &newA); CHK;
 
-        // get VecScatters between original data layout and the new one
-        ierr = getVecScatter(A, newA, is); CHK;
+        // get VecScatters between original data layout and the new one;
+        // updateA re-uses those of setA
+        if (scatterLhs == nullptr)
+        {
+            ierr = getVecScatter(A, newA, is); CHK;
+        }
 
         // destroy the temporary IS
         ierr = ISDestroy(&is); CHK;
     }
 
+    ierr = eventEnd(EvRedistMat); CHK;
+
     PetscFunctionReturn(0);
 }
 
@@ -251,6 +452,8 @@ PetscErrorCode AmgXSolver::getLocalMatRawData(const Mat &localA,
 
     PetscBool           done;
 
+    ierr = eventBegin(EvGetRawData); CHK;
+
     // get row and column indices in compressed row format
     ierr = MatGetRowIJ(localA, 0, PETSC_FALSE, PETSC_FALSE,
             &rawN, &rawRow, &rawCol, &done); CHK;
@@ -283,6 +486,62 @@ PetscErrorCode AmgXSolver::getLocalMatRawData(const Mat &localA,
     // return ownership of memory space to PETSc
     ierr = MatSeqAIJRestoreArray(localA, &rawData); CHK;
 
+    ierr = eventEnd(EvGetRawData); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::dropSmall */
+PetscErrorCode AmgXSolver::dropSmall(const IS &devIS, const PetscReal tol,
+        std::vector<PetscInt> &row, std::vector<PetscInt64> &col,
+        std::vector<PetscScalar> &data)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    const PetscInt      *globalRow;
+
+    PetscInt            nRows = row.size() - 1,
+                        nKept = 0;
+
+    // local rows of the redistributed matrix are the sorted rows in devIS
+    ierr = ISGetIndices(devIS, &globalRow); CHK;
+
+    keptNz.reserve(col.size());
+
+    for (PetscInt i = 0, bg = 0; i < nRows; ++i)
+    {
+        const PetscInt  ed = row[i+1];
+
+        PetscReal       rowMax = 0.0;
+
+        for (PetscInt j = bg; j < ed; ++j)
+            rowMax = std::max(rowMax, PetscAbsScalar(data[j]));
+
+        // diagonals always stay, so that smoothers keep working
+        for (PetscInt j = bg; j < ed; ++j)
+        {
+            if (col[j] != globalRow[i] &&
+                    PetscAbsScalar(data[j]) < tol * rowMax) continue;
+
+            col[nKept] = col[j];
+            data[nKept] = data[j];
+            keptNz.push_back(j);
+            ++nKept;
+        }
+
+        // compress in place; the old end is the begin of the next row
+        row[i+1] = nKept;
+        bg = ed;
+    }
+
+    ierr = ISRestoreIndices(devIS, &globalRow); CHK;
+
+    col.resize(nKept);
+    data.resize(nKept);
+
     PetscFunctionReturn(0);
 }
 
@@ -360,12 +619,21 @@ PetscErrorCode AmgXSolver::getPartData(
     PetscInt            n;
     PetscScalar         *tempPartVec;
 
+    PetscBool           forceVector = PETSC_FALSE;
+
+    ierr = eventBegin(EvGetPartData); CHK;
+
     ierr = ISGetLocalSize(devIS, &n); CHK;
 
     if (gpuWorld != MPI_COMM_NULL)
     {
         // check if sorted/contiguous, then we can skip expensive scatters
         checkForContiguousPartitioning(devIS, usesOffsets, partData);
+
+        // benchmarks may ask for the general code path on purpose
+        ierr = PetscOptionsGetBool(nullptr, nullptr,
+                "-amgx_partition_vector", &forceVector, nullptr); CHK;
+        if (forceVector) usesOffsets = PETSC_FALSE;
         if (!usesOffsets)
         {
             ierr = VecCreateMPI(gpuWorld, n, N, &tempMPI); CHK;
@@ -392,7 +660,9 @@ PetscErrorCode AmgXSolver::getPartData(
             ierr = VecDestroy(&tempSEQ); CHK;
         }
     }
-    ierr = MPI_Barrier(globalCpuWorld); CHK;
+    ierr = barrier(globalCpuWorld); CHK;
+
+    ierr = eventEnd(EvGetPartData); CHK;
 
     PetscFunctionReturn(0);
 }
@@ -410,43 +680,101 @@ PetscErrorCode AmgXSolver::setA(
 {
     PetscFunctionBeginUser;
 
-    // Merge the distributed matrix for MPI processes sharing a GPU
-    consolidateMatrix(nLocalRows, nLocalNz, rowOffsets, colIndicesGlobal, values);
+    double tic = MPI_Wtime();
+
+    std::string gridStats;
+
+    std::vector<float> narrowed;
+
+    const void *data;
+
+    bool changed;
 
     int ierr;
 
+    // the refinement computes residuals with a PETSc Mat
+    if (refine)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "-amgx_refine requires setA with a PETSc Mat.\n");
+
+    // the calling thread may not have used the device of this process yet
+    ierr = bindDevice(); CHK;
+    ierr = useStream(); CHK;
+
+    // the first matrix of this instance creates its AmgX objects
+    ierr = startAmgX(); CHK;
+
+    // updateA(const Mat &) only follows setA(const Mat &), and AmgX's own
+    // solver runs on this matrix
+    ierr = ISDestroy(&lastDevIS); CHK;
+    ierr = KSPDestroy(&outerKsp); CHK;
+    ierr = KSPDestroy(&hostKsp); CHK;
+    dropTol = 0.0;
+    keptNz.clear();
+
+    // Merge the distributed matrix for MPI processes sharing a GPU
+    consolidateMatrix(nLocalRows, nLocalNz, rowOffsets, colIndicesGlobal, values);
+
     // upload matrix A to AmgX
     if (gpuWorld != MPI_COMM_NULL)
     {
-        ierr = MPI_Barrier(gpuWorld); CHK;
+        ierr = barrier(gpuWorld); CHK;
+
+        ierr = eventBegin(EvUploadA); CHK;
 
         if (consolidationStatus == ConsolidationStatus::None)
         {
+            ierr = matValues(values, nLocalNz, narrowed, data); CHK;
+
             AMGX_matrix_upload_all_global_32(
                 AmgXA, nGlobalRows, nLocalRows, nLocalNz,
-                1, 1, rowOffsets, colIndicesGlobal, values,
+                1, 1, rowOffsets, colIndicesGlobal, data,
                 nullptr, ring, ring, partData);
+
+            ierr = logCpuToGpu(data, sizeof(PetscInt) * (nLocalRows + 1)
+                    + (sizeof(PetscInt) + matBytes()) * nLocalNz); CHK;
         }
         else
         {
+            ierr = matValues(valuesCons, nConsNz, narrowed, data); CHK;
+
             AMGX_matrix_upload_all_global_32(
                 AmgXA, nGlobalRows, nConsRows, nConsNz,
-                1, 1, rowOffsetsCons, colIndicesGlobalCons, valuesCons,
+                1, 1, rowOffsetsCons, colIndicesGlobalCons, data,
                 nullptr, ring, ring, partData);
 
+            ierr = logCpuToGpu(data, sizeof(PetscInt) * (nConsRows + 1)
+                    + (sizeof(PetscInt) + matBytes()) * nConsNz); CHK;
+
             // The rowOffsets and colIndices are no longer needed
             freeConsStructure();
         }
 
+        ierr = eventEnd(EvUploadA); CHK;
+
+        // no outer KSP with raw arrays; the setup below covers a new solver
+        ierr = stopAmgX(false, changed); CHK;
+
         // bind the matrix A to the solver
-        ierr = MPI_Barrier(gpuWorld); CHK;
-        AMGX_solver_setup(solver, AmgXA);
+        ierr = barrier(gpuWorld); CHK;
+        ierr = setupSolver(false, gridStats); CHK;
 
         // connect (bind) vectors to the matrix
         AMGX_vector_bind(AmgXP, AmgXA);
         AMGX_vector_bind(AmgXRHS, AmgXA);
     }
-    ierr = MPI_Barrier(globalCpuWorld); CHK;
+    ierr = barrier(globalCpuWorld); CHK;
+
+    // get statistics of the new hierarchy
+    ierr = parseGridStats(gridStats); CHK;
+    ierr = resetReuse(); CHK;
+
+    hasA = true;
+
+    addSample(StSetup, MPI_Wtime() - tic);
+
+    ierr = recordSetA(nGlobalRows, nLocalRows, nLocalNz,
+            rowOffsets, colIndicesGlobal, values, partData, tic); CHK;
 
     PetscFunctionReturn(0);
 }
@@ -459,31 +787,243 @@ PetscErrorCode AmgXSolver::updateA(
 {
     PetscFunctionBeginUser;
 
+    PetscErrorCode      ierr;
+
+    ierr = updateA_raw(nLocalRows, nLocalNz, values); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::updateA */
+PetscErrorCode AmgXSolver::updateA(
+    const PetscInt nLocalRows,
+    const PetscInt nLocalNz,
+    const float* values)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    // AmgX takes the values as they are, in the precision of the mode
+    if (! floatMat)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONG,
+                "Updating with float values requires the mode dDFI, dFFI, "
+                "hDFI, or hFFI.\n");
+
+    ierr = updateA_raw(nLocalRows, nLocalNz, values); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::updateA_raw */
+template <typename T>
+PetscErrorCode AmgXSolver::updateA_raw(
+    const PetscInt nLocalRows,
+    const PetscInt nLocalNz,
+    const T* values)
+{
+    PetscFunctionBeginUser;
+
+    double tic = MPI_Wtime();
+
+    std::string gridStats;
+
+    std::vector<float> narrowed;
+
+    const void *data;
+
+    int ierr;
+
+    // the consolidation buffer holds PetscScalar, so it also fits floats
+    const T *valuesC = reinterpret_cast<const T*>(valuesCons);
+
+    // the calling thread may not have used the device of this process yet
+    ierr = bindDevice(); CHK;
+    ierr = useStream(); CHK;
+
+    // the reuse policy may keep the hierarchy and only swap fine values
+    const bool keep = keepHierarchy();
+
     // Merges the values from multiple MPI processes sharing a single GPU
     reconsolidateValues(nLocalNz, values);
 
-    int ierr;
     // Replace the coefficients for the CSR matrix A within AmgX
     if (gpuWorld != MPI_COMM_NULL)
     {
-        ierr = MPI_Barrier(gpuWorld); CHK;
+        ierr = barrier(gpuWorld); CHK;
+
+        ierr = eventBegin(EvUploadA); CHK;
 
         if (consolidationStatus == ConsolidationStatus::None)
         {
-            AMGX_matrix_replace_coefficients(AmgXA, nLocalRows, nLocalNz, values, nullptr);
+            ierr = matValues(values, nLocalNz, narrowed, data); CHK;
+
+            AMGX_matrix_replace_coefficients(AmgXA, nLocalRows, nLocalNz, data, nullptr);
+
+            ierr = logCpuToGpu(data, matBytes() * nLocalNz); CHK;
         }
         else
         {
-            AMGX_matrix_replace_coefficients(AmgXA, nConsRows, nConsNz, valuesCons, nullptr);
+            ierr = matValues(valuesC, nConsNz, narrowed, data); CHK;
+
+            AMGX_matrix_replace_coefficients(AmgXA, nConsRows, nConsNz, data, nullptr);
+
+            ierr = logCpuToGpu(data, matBytes() * nConsNz); CHK;
         }
 
-        ierr = MPI_Barrier(gpuWorld); CHK;
+        ierr = eventEnd(EvUploadA); CHK;
+
+        ierr = barrier(gpuWorld); CHK;
 
         // Re-setup the solver (a reduced overhead setup that accounts for consistent matrix structure)
-        AMGX_solver_resetup(solver, AmgXA);
+        if (! keep)
+        {
+            ierr = setupSolver(true, gridStats); CHK;
+        }
+    }
+
+    ierr = barrier(globalCpuWorld); CHK;
+
+    // get statistics of the updated hierarchy
+    if (! keep)
+    {
+        ierr = parseGridStats(gridStats); CHK;
+    }
+
+    addSample(StResetup, MPI_Wtime() - tic);
+
+    ierr = recordUpdateA(nLocalRows, nLocalNz, values, tic); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::updateA */
+PetscErrorCode AmgXSolver::updateA(const Mat &A)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (hostKsp != nullptr)
+    {
+        ierr = updateHost(A); CHK;
+        PetscFunctionReturn(0);
+    }
+
+    ierr = updateA_mat(A); CHK;
+
+    // the outer KSP of -amgx_refine or -amgx_drop_tol applies the new Mat
+    ierr = setOperator(A, A); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::updateA */
+PetscErrorCode AmgXSolver::updateA(const Mat &A, const Mat &P)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (hostKsp != nullptr)
+    {
+        ierr = updateHost(A); CHK;
+        PetscFunctionReturn(0);
+    }
+
+    ierr = updateA_mat(P); CHK;
+    ierr = setOperator(A, P); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::updateA_mat */
+PetscErrorCode AmgXSolver::updateA_mat(const Mat &A)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    Mat                 localA;
+
+    PetscInt            nLocalRows;
+
+    std::vector<PetscInt>       row;
+    std::vector<PetscInt64>     col;
+    std::vector<PetscScalar>    data;
+    std::vector<float>          narrowed;
+
+    const void          *values;
+
+    std::string         gridStats;
+
+    double              tic = MPI_Wtime();
+
+    if (lastDevIS == nullptr)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "updateA with a Mat requires a previous setA with a Mat.\n");
+
+    // the calling thread may not have used the device of this process yet
+    ierr = bindDevice(); CHK;
+
+    // the reuse policy may keep the hierarchy and only swap fine values
+    const bool          keep = keepHierarchy();
+
+    // rows are redistributed as in the last setA, so getDevIS, getPartData,
+    // and the scatters of vectors are skipped
+    ierr = getLocalA(A, lastDevIS, localA); CHK;
+    ierr = getLocalMatRawData(localA, nLocalRows, row, col, data); CHK;
+    ierr = destroyLocalA(A, localA); CHK;
+
+    // keep the entries that survived the drop tolerance of setA
+    if (dropTol > 0.0)
+    {
+        for (size_t i = 0; i < keptNz.size(); ++i) data[i] = data[keptNz[i]];
+        data.resize(keptNz.size());
+        row[nLocalRows] = keptNz.size();
     }
 
-    ierr = MPI_Barrier(globalCpuWorld); CHK;
+    // Replace the coefficients for the CSR matrix A within AmgX
+    if (gpuWorld != MPI_COMM_NULL)
+    {
+        ierr = barrier(gpuWorld); CHK;
+
+        ierr = eventBegin(EvUploadA); CHK;
+
+        ierr = matValues(data.data(), data.size(), narrowed, values); CHK;
+
+        AMGX_matrix_replace_coefficients(
+                AmgXA, nLocalRows, row[nLocalRows], values, nullptr);
+
+        ierr = logCpuToGpu(values, matBytes() * data.size()); CHK;
+
+        ierr = eventEnd(EvUploadA); CHK;
+
+        ierr = barrier(gpuWorld); CHK;
+
+        // a reduced overhead setup that re-uses the structure of the hierarchy
+        if (! keep)
+        {
+            ierr = setupSolver(true, gridStats); CHK;
+        }
+    }
+
+    ierr = barrier(globalCpuWorld); CHK;
+
+    // get statistics of the updated hierarchy
+    if (! keep)
+    {
+        ierr = parseGridStats(gridStats); CHK;
+    }
+
+    addSample(StResetup, MPI_Wtime() - tic);
+
+    ierr = recordUpdateA(A, tic); CHK;
 
     PetscFunctionReturn(0);
 }
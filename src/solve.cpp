@@ -8,8 +8,13 @@
  */
 
 
+// STD
+# include <algorithm>
+# include <type_traits>
+
 // AmgXWrapper
 # include "AmgXSolver.hpp"
+# include "AmgXRecord.hpp"
 
 
 /* \implements AmgXSolver::solve */
@@ -19,8 +24,176 @@ PetscErrorCode AmgXSolver::solve(Vec &p, Vec &b)
 
     PetscErrorCode      ierr;
 
+    ierr = solve_vec(p, b, nullptr); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve */
+PetscErrorCode AmgXSolver::solve(Vec &p, Vec &b, SolveReport &report)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = solve_vec(p, b, &report); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve */
+PetscErrorCode AmgXSolver::solve(
+        PetscScalar *p, const PetscScalar *b, const int nRows)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = solve_raw(p, b, nRows, nullptr); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve */
+PetscErrorCode AmgXSolver::solve(PetscScalar *p, const PetscScalar *b,
+        const int nRows, SolveReport &report)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = solve_raw(p, b, nRows, &report); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve */
+PetscErrorCode AmgXSolver::solve(float *p, const float *b, const int nRows)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = solve_raw(p, b, nRows, nullptr); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve */
+PetscErrorCode AmgXSolver::solve(float *p, const float *b,
+        const int nRows, SolveReport &report)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = solve_raw(p, b, nRows, &report); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve_vec */
+PetscErrorCode AmgXSolver::solve_vec(Vec &p, Vec &b, SolveReport *report)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    double              tic = MPI_Wtime();
+
+    const PetscScalar   *array;
+    PetscInt            n;
+
+    PetscInt            iters = 0;
+    int                 amgxIters = 0;
+
+    Vec                 rhs = b;
+
+    if (! hasA)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "solve requires a matrix given to setA.\n");
+
+    // the calling thread may not have used the device of this process yet
+    ierr = bindDevice(); CHK;
+
+    // timings in the report only cover this solve
+    std::fill(phaseTime, phaseTime + nEvents, 0.0);
+
+    // the solve overwrites the initial guess, so keep it for the record
+    if (recordFp != nullptr)
+    {
+        ierr = VecGetLocalSize(p, &n); CHK;
+        ierr = VecGetArrayRead(p, &array); CHK;
+        ierr = keepGuess(array, n); CHK;
+        ierr = VecRestoreArrayRead(p, &array); CHK;
+    }
+
+    // a singular system only has a solution for the part of b in the range
+    if (nullSpace != nullptr)
+    {
+        ierr = projectRhs(b, rhs); CHK;
+    }
+
+    // the iterations are those of the solver that owns the solve
+    if (hostKsp != nullptr)
+    {
+        ierr = solve_host(p, rhs, report); CHK;
+        ierr = KSPGetIterationNumber(hostKsp, &iters); CHK;
+    }
+    else if (outerKsp != nullptr)
+    {
+        ierr = solve_outer(p, rhs, report); CHK;
+        ierr = KSPGetIterationNumber(outerKsp, &iters); CHK;
+    }
+    else
+    {
+        ierr = solve_dist(p, rhs, report); CHK;
+
+        if (hasAmgX) AMGX_solver_get_iterations_number(solver, &amgxIters);
+        iters = amgxIters;
+    }
+
+    // adding any vector of the null space gives another solution; return
+    // the one without
+    if (nullSpace != nullptr)
+    {
+        ierr = MatNullSpaceRemove(nullSpace, p); CHK;
+    }
+
+    ierr = recordSolve(MPI_Wtime() - tic, iters); CHK;
+
+    if (recordFp != nullptr)
+    {
+        ierr = VecGetArrayRead(b, &array); CHK;
+        ierr = recordSolveCall(AmgXRecord::SolveVec, array, n, tic); CHK;
+        ierr = VecRestoreArrayRead(b, &array); CHK;
+    }
+
+    ierr = finishReport(report); CHK;
+
+    // rebuild the hierarchy if iterations grew too much
+    ierr = checkReuse(); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve_dist */
+PetscErrorCode AmgXSolver::solve_dist(Vec &p, Vec &b, SolveReport *report)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
     if (globalSize != gpuWorldSize)
     {
+        ierr = eventBegin(EvVecScatter); CHK;
         ierr = VecScatterBegin(scatterRhs,
                 b, redistRhs, INSERT_VALUES, SCATTER_FORWARD); CHK;
         ierr = VecScatterBegin(scatterLhs,
@@ -30,33 +203,96 @@ PetscErrorCode AmgXSolver::solve(Vec &p, Vec &b)
                 b, redistRhs, INSERT_VALUES, SCATTER_FORWARD); CHK;
         ierr = VecScatterEnd(scatterLhs,
                 p, redistLhs, INSERT_VALUES, SCATTER_FORWARD); CHK;
+        ierr = eventEnd(EvVecScatter); CHK;
 
         if (gpuWorld != MPI_COMM_NULL)
         {
-            ierr = solve_real(redistLhs, redistRhs); CHK;
+            ierr = solve_real(redistLhs, redistRhs, report); CHK;
         }
-        ierr = MPI_Barrier(globalCpuWorld); CHK;
+        ierr = barrier(globalCpuWorld); CHK;
 
+        ierr = eventBegin(EvVecScatter); CHK;
         ierr = VecScatterBegin(scatterLhs,
                 redistLhs, p, INSERT_VALUES, SCATTER_REVERSE); CHK;
         ierr = VecScatterEnd(scatterLhs,
                 redistLhs, p, INSERT_VALUES, SCATTER_REVERSE); CHK;
+        ierr = eventEnd(EvVecScatter); CHK;
     }
     else
     {
         if (gpuWorld != MPI_COMM_NULL)
         {
-            ierr = solve_real(p, b); CHK;
+            ierr = solve_real(p, b, report); CHK;
         }
-        ierr = MPI_Barrier(globalCpuWorld); CHK;
+        ierr = barrier(globalCpuWorld); CHK;
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::solve_outer */
+PetscErrorCode AmgXSolver::solve_outer(Vec &p, Vec &b, SolveReport *report)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    KSPConvergedReason  reason;
+    PetscInt            iters;
+
+    ierr = KSPSolve(outerKsp, b, p); CHK;
+
+    ierr = KSPGetConvergedReason(outerKsp, &reason); CHK;
+    ierr = KSPGetIterationNumber(outerKsp, &iters); CHK;
+
+    if (report == nullptr)
+    {
+        if (reason < 0) SETERRQ1(globalCpuWorld, PETSC_ERR_CONV_FAILED,
+                "The Krylov solver on A failed to solve the system! "
+                "The reason is %d.\n", (int) reason);
+
+        PetscFunctionReturn(0);
     }
 
+    // the outcome is that of the Krylov solver on A, not of AmgX on P
+    report->status = (reason < 0) ? AMGX_SOLVE_DIVERGED : AMGX_SOLVE_SUCCESS;
+    report->iters = iters;
+    report->residuals.clear();
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::applyOuterPC */
+PetscErrorCode AmgXSolver::applyOuterPC(PC pc, Vec x, Vec y)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    AmgXSolver          *self;
+
+    SolveReport         inner;
+
+    ierr = PCShellGetContext(pc, (void**) &self); CHK;
+
+    // AmgX solves P y = x from a zero guess; FGMRES tolerates an inexact or
+    // varying solve, so only a failure of AmgX is an error
+    ierr = VecSet(y, 0.0); CHK;
+    ierr = self->solve_dist(y, x, &inner); CHK;
+    ierr = self->finishReport(&inner); CHK;
+
+    if (inner.status == AMGX_SOLVE_FAILED)
+        SETERRQ(self->globalCpuWorld, PETSC_ERR_LIB,
+                "AmgX failed to apply the preconditioner.\n");
+
     PetscFunctionReturn(0);
 }
 
 
 /* \implements AmgXSolver::solve_real */
-PetscErrorCode AmgXSolver::solve_real(Vec &p, Vec &b)
+PetscErrorCode AmgXSolver::solve_real(Vec &p, Vec &b, SolveReport *report)
 {
     PetscFunctionBeginUser;
 
@@ -65,9 +301,10 @@ PetscErrorCode AmgXSolver::solve_real(Vec &p, Vec &b)
     double              *unks,
                         *rhs;
 
-    int                 size;
+    std::vector<float>  unksF,
+                        rhsF;
 
-    AMGX_SOLVE_STATUS   status;
+    int                 size;
 
     // get size of local vector (p and b should have the same local size)
     ierr = VecGetLocalSize(p, &size); CHK;
@@ -77,23 +314,49 @@ PetscErrorCode AmgXSolver::solve_real(Vec &p, Vec &b)
     ierr = VecGetArray(b, &rhs); CHK;
 
     // upload vectors to AmgX
-    AMGX_vector_upload(AmgXP, size, 1, unks);
-    AMGX_vector_upload(AmgXRHS, size, 1, rhs);
+    ierr = eventBegin(EvVecUpload); CHK;
+    if (floatVec)
+    {
+        // AmgX reads the vectors as float in dFFI and hFFI
+        unksF.assign(unks, unks + size);
+        rhsF.assign(rhs, rhs + size);
+
+        AMGX_vector_upload(AmgXP, size, 1, unksF.data());
+        AMGX_vector_upload(AmgXRHS, size, 1, rhsF.data());
+        ierr = logCpuToGpu(unksF.data(), 2 * sizeof(float) * size); CHK;
+    }
+    else
+    {
+        AMGX_vector_upload(AmgXP, size, 1, unks);
+        AMGX_vector_upload(AmgXRHS, size, 1, rhs);
+        ierr = logCpuToGpu(unks, 2 * sizeof(PetscScalar) * size); CHK;
+    }
+    ierr = eventEnd(EvVecUpload); CHK;
 
     // solve
-    ierr = MPI_Barrier(gpuWorld); CHK;
+    ierr = barrier(gpuWorld); CHK;
+    ierr = eventBegin(EvSolve); CHK;
     AMGX_solver_solve(solver, AmgXRHS, AmgXP);
-
-    // get the status of the solver
-    AMGX_solver_get_status(solver, &status);
+    ierr = eventEnd(EvSolve); CHK;
 
     // check whether the solver successfully solve the problem
-    if (status != AMGX_SOLVE_SUCCESS) SETERRQ1(globalCpuWorld,
-            PETSC_ERR_CONV_FAILED, "AmgX solver failed to solve the system! "
-            "The error code is %d.\n", status);
+    ierr = checkStatus(report); CHK;
 
     // download data from device
-    AMGX_vector_download(AmgXP, unks);
+    ierr = eventBegin(EvVecDownload); CHK;
+    if (floatVec)
+    {
+        AMGX_vector_download(AmgXP, unksF.data());
+        ierr = logGpuToCpu(unksF.data(), sizeof(float) * size); CHK;
+
+        std::copy(unksF.begin(), unksF.end(), unks);
+    }
+    else
+    {
+        AMGX_vector_download(AmgXP, unks);
+        ierr = logGpuToCpu(unks, sizeof(PetscScalar) * size); CHK;
+    }
+    ierr = eventEnd(EvVecDownload); CHK;
 
     // restore PETSc vectors
     ierr = VecRestoreArray(p, &unks); CHK;
@@ -103,93 +366,237 @@ PetscErrorCode AmgXSolver::solve_real(Vec &p, Vec &b)
 }
 
 
-/* \implements AmgXSolver::solve */
-PetscErrorCode AmgXSolver::solve(PetscScalar* p, const PetscScalar* b, const int nRows)
+/* \implements AmgXSolver::solve_raw */
+template <typename T>
+PetscErrorCode AmgXSolver::solve_raw(T *p, const T *b,
+        const int nRows, SolveReport *report)
 {
     PetscFunctionBeginUser;
 
     int ierr;
 
+    int iters = 0;
+
+    double              tic = MPI_Wtime();
+
+    // the consolidation buffers hold PetscScalar, so they also fit floats
+    T                   *pC = reinterpret_cast<T*>(pCons),
+                        *rhsC = reinterpret_cast<T*>(rhsCons);
+
+    const MPI_Datatype  type = mpiType(p);
+
+    // AmgX takes the arrays as they are, in the precision of the mode
+    if (std::is_same<T, float>::value && ! floatVec)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONG,
+                "Solving with float arrays requires the mode dFFI or hFFI.\n");
+
+    if (! std::is_same<T, float>::value && floatVec)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONG,
+                "The modes dFFI and hFFI need float arrays for solving with "
+                "raw arrays.\n");
+
+    // the operator A of setA(A, P), or of a host solve, is a PETSc Mat
+    if (outerKsp != nullptr || hostKsp != nullptr)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "Solving with raw arrays requires a single matrix in AmgX.\n");
+
+    if (! hasA)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "solve requires a matrix given to setA.\n");
+
+    // the basis of the null space are PETSc Vecs
+    if (nullSpace != nullptr)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "A null space requires solving with PETSc Vecs.\n");
+
+    // the calling thread may not have used the device of this process yet
+    ierr = bindDevice(); CHK;
+    ierr = useStream(); CHK;
+
+    // timings in the report only cover this solve
+    std::fill(phaseTime, phaseTime + nEvents, 0.0);
+
+    // the solve overwrites the initial guess, so keep it for the record
+    ierr = keepGuess(p, nRows); CHK;
+
+    ierr = eventBegin(EvVecScatter); CHK;
+
     if (consolidationStatus == ConsolidationStatus::Device)
     {
-        CHECK(cudaMemcpy((void**)&pCons[rowDispls[myDevWorldRank]], p, sizeof(PetscScalar) * nRows, cudaMemcpyDefault));
-        CHECK(cudaMemcpy((void**)&rhsCons[rowDispls[myDevWorldRank]], b, sizeof(PetscScalar) * nRows, cudaMemcpyDefault));
+        CHECK(cudaMemcpyAsync((void**)&pC[rowDispls[myDevWorldRank]], p, sizeof(T) * nRows, cudaMemcpyDefault, stream));
+        CHECK(cudaMemcpyAsync((void**)&rhsC[rowDispls[myDevWorldRank]], b, sizeof(T) * nRows, cudaMemcpyDefault, stream));
 
-        // Must synchronize here as device to device copies are non-blocking w.r.t host
-        CHECK(cudaDeviceSynchronize());
-        ierr = MPI_Barrier(devWorld); CHK;
+        // Must synchronize here as the copies are asynchronous w.r.t host
+        CHECK(cudaStreamSynchronize(stream));
+        ierr = barrier(devWorld); CHK;
     }
     else if (consolidationStatus == ConsolidationStatus::Host)
     {
         MPI_Request req[2];
-        ierr = MPI_Igatherv(p, nRows, MPI_DOUBLE, &pCons[rowDispls[myDevWorldRank]], nRowsInDevWorld.data(), rowDispls.data(), MPI_DOUBLE, 0, devWorld, &req[0]); CHK;
-        ierr = MPI_Igatherv(b, nRows, MPI_DOUBLE, &rhsCons[rowDispls[myDevWorldRank]], nRowsInDevWorld.data(), rowDispls.data(), MPI_DOUBLE, 0, devWorld, &req[1]); CHK;
-        MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+        ierr = MPI_Igatherv(p, nRows, type, &pC[rowDispls[myDevWorldRank]], nRowsInDevWorld.data(), rowDispls.data(), type, 0, devWorld, &req[0]); CHK;
+        ierr = MPI_Igatherv(b, nRows, type, &rhsC[rowDispls[myDevWorldRank]], nRowsInDevWorld.data(), rowDispls.data(), type, 0, devWorld, &req[1]); CHK;
+        ierr = waitAll(2, req); CHK;
     }
 
+    ierr = eventEnd(EvVecScatter); CHK;
+
     if (gpuWorld != MPI_COMM_NULL)
     {
         // Upload potentially consolidated vectors to AmgX
+        ierr = eventBegin(EvVecUpload); CHK;
         if (consolidationStatus == ConsolidationStatus::None)
         {
             AMGX_vector_upload(AmgXP, nRows, 1, p);
             AMGX_vector_upload(AmgXRHS, nRows, 1, b);
+            ierr = logCpuToGpu(p, 2 * sizeof(T) * nRows); CHK;
         }
         else
         {
-            AMGX_vector_upload(AmgXP, nConsRows, 1, pCons);
-            AMGX_vector_upload(AmgXRHS, nConsRows, 1, rhsCons);
+            AMGX_vector_upload(AmgXP, nConsRows, 1, pC);
+            AMGX_vector_upload(AmgXRHS, nConsRows, 1, rhsC);
+            ierr = logCpuToGpu(pC, 2 * sizeof(T) * nConsRows); CHK;
         }
+        ierr = eventEnd(EvVecUpload); CHK;
 
-        ierr = MPI_Barrier(gpuWorld); CHK;
+        ierr = barrier(gpuWorld); CHK;
 
         // Solve
+        ierr = eventBegin(EvSolve); CHK;
         AMGX_solver_solve(solver, AmgXRHS, AmgXP);
-
-        // Get the status of the solver
-        AMGX_SOLVE_STATUS   status;
-        AMGX_solver_get_status(solver, &status);
+        ierr = eventEnd(EvSolve); CHK;
 
         // Check whether the solver successfully solved the problem
-        if (status != AMGX_SOLVE_SUCCESS)
-                SETERRQ1(globalCpuWorld,
-                        PETSC_ERR_CONV_FAILED, "AmgX solver failed to solve the system! "
-                                                "The error code is %d.\n",
-                        status);
+        ierr = checkStatus(report); CHK;
 
         // Download data from device
+        ierr = eventBegin(EvVecDownload); CHK;
         if (consolidationStatus == ConsolidationStatus::None)
         {
             AMGX_vector_download(AmgXP, p);
+            ierr = logGpuToCpu(p, sizeof(T) * nRows); CHK;
         }
         else
         {
-            AMGX_vector_download(AmgXP, pCons);
+            AMGX_vector_download(AmgXP, pC);
+            ierr = logGpuToCpu(pC, sizeof(T) * nConsRows); CHK;
 
-            // AMGX_vector_download invokes a device to device copy here, so it is essential that
-            // the root rank blocks the host before other ranks copy from the consolidated solution
-            CHECK(cudaDeviceSynchronize());
+            // AMGX_vector_download invokes a device to device copy on the default stream here, so it
+            // is essential that the root rank blocks the host before other ranks copy from the
+            // consolidated solution
+            CHECK(cudaStreamSynchronize(0));
         }
+        ierr = eventEnd(EvVecDownload); CHK;
     }
 
+    ierr = eventBegin(EvVecScatter); CHK;
+
     // If the matrix is consolidated, scatter the
     if (consolidationStatus == ConsolidationStatus::Device)
     {
         // Must synchronise before each rank attempts to read from the consolidated solution
-        ierr = MPI_Barrier(devWorld); CHK;
+        ierr = barrier(devWorld); CHK;
 
-        CHECK(cudaMemcpy((void **)p, &pCons[rowDispls[myDevWorldRank]], sizeof(PetscScalar) * nRows, cudaMemcpyDefault));
-        CHECK(cudaDeviceSynchronize());
+        CHECK(cudaMemcpyAsync((void **)p, &pC[rowDispls[myDevWorldRank]], sizeof(T) * nRows, cudaMemcpyDefault, stream));
+        CHECK(cudaStreamSynchronize(stream));
     }
     else if (consolidationStatus == ConsolidationStatus::Host)
     {
         // Must synchronise before each rank attempts to read from the consolidated solution
-        ierr = MPI_Barrier(devWorld); CHK;
+        ierr = barrier(devWorld); CHK;
 
-        ierr = MPI_Scatterv(&pCons[rowDispls[myDevWorldRank]], nRowsInDevWorld.data(), rowDispls.data(), MPI_DOUBLE, p, nRows, MPI_DOUBLE, 0, devWorld); CHK;
+        ierr = MPI_Scatterv(&pC[rowDispls[myDevWorldRank]], nRowsInDevWorld.data(), rowDispls.data(), type, p, nRows, type, 0, devWorld); CHK;
     }
 
-    ierr = MPI_Barrier(globalCpuWorld); CHK;
+    ierr = eventEnd(EvVecScatter); CHK;
+
+    ierr = barrier(globalCpuWorld); CHK;
+
+    // only processes using AmgX have iterations
+    if (hasAmgX) AMGX_solver_get_iterations_number(solver, &iters);
+
+    ierr = recordSolve(MPI_Wtime() - tic, iters); CHK;
+
+    ierr = recordSolveCall(std::is_same<T, float>::value ?
+            AmgXRecord::SolveRawFloat : AmgXRecord::SolveRaw,
+            b, nRows, tic); CHK;
+
+    ierr = finishReport(report); CHK;
+
+    // rebuild the hierarchy if iterations grew too much
+    ierr = checkReuse(); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::checkStatus */
+PetscErrorCode AmgXSolver::checkStatus(SolveReport *report)
+{
+    PetscFunctionBeginUser;
+
+    AMGX_SOLVE_STATUS   status;
+
+    // get the status of the solver
+    AMGX_solver_get_status(solver, &status);
+
+    if (report == nullptr)
+    {
+        if (status != AMGX_SOLVE_SUCCESS) SETERRQ1(globalCpuWorld,
+                PETSC_ERR_CONV_FAILED, "AmgX solver failed to solve the system! "
+                "The error code is %d.\n", status);
+
+        PetscFunctionReturn(0);
+    }
+
+    report->status = status;
+    AMGX_solver_get_iterations_number(solver, &report->iters);
+
+    // the history only exists with store_res_history=1; stop at the first
+    // iteration AmgX can not provide
+    report->residuals.clear();
+    report->residuals.reserve(report->iters + 1);
+    for (int i = 0; i <= report->iters; ++i)
+    {
+        double      res;
+
+        if (AMGX_solver_get_iteration_residual(
+                    solver, i, 0, &res) != AMGX_RC_OK) break;
+
+        report->residuals.push_back(res);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::finishReport */
+PetscErrorCode AmgXSolver::finishReport(SolveReport *report)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    int                 info[3];
+
+    if (report == nullptr) PetscFunctionReturn(0);
+
+    // the rank 0 of globalCpuWorld is always in gpuWorld
+    info[0] = report->status;
+    info[1] = report->iters;
+    info[2] = report->residuals.size();
+    ierr = MPI_Bcast(info, 3, MPI_INT, 0, globalCpuWorld); CHK;
+
+    report->status = static_cast<AMGX_SOLVE_STATUS>(info[0]);
+    report->iters = info[1];
+    report->residuals.resize(info[2]);
+    ierr = MPI_Bcast(report->residuals.data(), info[2],
+            MPI_DOUBLE, 0, globalCpuWorld); CHK;
+
+    report->scatterTime = phaseTime[EvVecScatter];
+    report->uploadTime = phaseTime[EvVecUpload];
+    report->solveTime = phaseTime[EvSolve];
+    report->downloadTime = phaseTime[EvVecDownload];
+    report->waitTime = phaseTime[EvMPIWait];
 
     PetscFunctionReturn(0);
 }
\ No newline at end of file
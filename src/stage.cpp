@@ -0,0 +1,338 @@
+/**
+ * \file stage.cpp
+ * \brief Definition of member functions regarding staged setups.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <utility>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::initStage */
+PetscErrorCode AmgXSolver::initStage()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscBool           async = PETSC_FALSE;
+
+    int                 provided;
+
+    ierr = PetscOptionsGetBool(nullptr, nullptr,
+            "-amgx_stage_async", &async, nullptr); CHK;
+
+    // AmgX talks MPI from the helper thread while the main thread solves
+    ierr = MPI_Query_thread(&provided); CHK;
+
+    stageAsync = async && (provided == MPI_THREAD_MULTIPLE);
+
+    if (async && ! stageAsync)
+    {
+        ierr = PetscPrintf(globalCpuWorld, "-amgx_stage_async needs "
+                "MPI_THREAD_MULTIPLE; staged setups will not overlap.\n"); CHK;
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::stageA */
+PetscErrorCode AmgXSolver::stageA(const Mat &A)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    StageJob            job;
+
+    double              tic = MPI_Wtime();
+
+    // swap leaves the instance as after setA(A) without an outer KSP
+    if (refine)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "-amgx_refine is not available with stageA.\n");
+
+    // the calling thread may not have used the device of this process yet
+    ierr = bindDevice(); CHK;
+
+    // the spare slot may still be busy with the previous stageA
+    ierr = waitStage(); CHK;
+
+    // the first matrix of this instance creates its AmgX objects
+    ierr = startAmgX(); CHK;
+
+    if (gpuWorld != MPI_COMM_NULL)
+    {
+        ierr = prepareSpare(); CHK;
+    }
+
+    // a matrix staged before is overwritten from here on
+    spare.staged = false;
+
+    // the PETSc side is done here, as in setA, but into the spare slot; the
+    // current slot comes back even if that fails
+    swapSlot();
+    ierr = stageLocal(A, job);
+    swapSlot();
+    CHK;
+
+    ierr = PetscObjectReference((PetscObject) A); CHK;
+    ierr = MatDestroy(&spare.mat); CHK;
+    spare.mat = A;
+
+    spare.staged = true;
+    spare.gridStats.clear();
+    spare.setupTime = MPI_Wtime() - tic;
+
+    // only the upload and the setup are left, and they need no PETSc
+    if (gpuWorld != MPI_COMM_NULL)
+    {
+        job.A = spare.A;
+        job.P = spare.P;
+        job.RHS = spare.RHS;
+        job.solver = spare.solver;
+        job.cfg = cfg;
+        job.devID = devID;
+        job.onHost = onHost;
+        job.floatMat = floatMat;
+
+        if (stageAsync)
+            stageThread = std::thread(runStage, std::move(job),
+                    &spare.gridStats, &spare.setupTime);
+        else
+            runStage(std::move(job), &spare.gridStats, &spare.setupTime);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::stageLocal */
+PetscErrorCode AmgXSolver::stageLocal(const Mat &A, StageJob &job)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    Mat                 localA;
+
+    IS                  devIS;
+
+    ierr = ISDestroy(&lastDevIS); CHK;
+    ierr = VecScatterDestroy(&scatterLhs); CHK;
+    ierr = VecScatterDestroy(&scatterRhs); CHK;
+    ierr = VecDestroy(&redistLhs); CHK;
+    ierr = VecDestroy(&redistRhs); CHK;
+
+    ierr = MatGetSize(A, &job.nGlobalRows, nullptr); CHK;
+    ierr = getDevIS(A, devIS); CHK;
+    ierr = getLocalA(A, devIS, localA); CHK;
+    ierr = getLocalMatRawData(localA,
+            job.nLocalRows, job.row, job.col, job.data); CHK;
+    ierr = destroyLocalA(A, localA); CHK;
+    ierr = getPartData(devIS, job.nGlobalRows,
+            job.partData, job.usesOffsets); CHK;
+
+    lastDevIS = devIS;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::swap */
+PetscErrorCode AmgXSolver::swap()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    double              tic = MPI_Wtime();
+
+    ierr = waitStage(); CHK;
+
+    if (! spare.staged)
+        SETERRQ(globalCpuWorld, PETSC_ERR_ARG_WRONGSTATE,
+                "swap requires a matrix given to stageA.\n");
+
+    // every rank must have finished before any rank solves with the new slot
+    ierr = barrier(globalCpuWorld); CHK;
+
+    swapSlot();
+    spare.staged = false;
+    hasA = true;
+
+    // as after setA with a single matrix
+    ierr = KSPDestroy(&outerKsp); CHK;
+    ierr = KSPDestroy(&hostKsp); CHK;
+    dropTol = 0.0;
+    keptNz.clear();
+
+    ierr = parseGridStats(spare.gridStats); CHK;
+    ierr = resetReuse(); CHK;
+
+    // AmgX owns the solves now, if an outer KSP did before
+    ierr = applyStopping(); CHK;
+
+    addSample(StSetup, spare.setupTime);
+
+    ierr = recordSetA(spare.mat, tic); CHK;
+    ierr = MatDestroy(&spare.mat); CHK;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::waitStage */
+PetscErrorCode AmgXSolver::waitStage()
+{
+    PetscFunctionBeginUser;
+
+    if (stageThread.joinable()) stageThread.join();
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::prepareSpare */
+PetscErrorCode AmgXSolver::prepareSpare()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    // handles on the other private resources can be set up again as they are
+    if (spare.solver != nullptr && spare.rsrcId >= 0) PetscFunctionReturn(0);
+
+    // handles left by the first swap are on the shared resources
+    if (spare.solver != nullptr)
+    {
+        AMGX_solver_destroy(spare.solver);
+        AMGX_matrix_destroy(spare.A);
+        AMGX_vector_destroy(spare.P);
+        AMGX_vector_destroy(spare.RHS);
+    }
+
+    const int   id = (activeRsrc == 0) ? 1 : 0;
+
+    if (stageRsrc[id] == nullptr)
+    {
+        ierr = MPI_Comm_dup(gpuWorld, &stageComm[id]); CHK;
+        AMGX_resources_create(&stageRsrc[id], cfg, &stageComm[id], 1, &devID);
+    }
+
+    AMGX_vector_create(&spare.P, stageRsrc[id], mode);
+    AMGX_vector_create(&spare.RHS, stageRsrc[id], mode);
+    AMGX_matrix_create(&spare.A, stageRsrc[id], mode);
+    AMGX_solver_create(&spare.solver, stageRsrc[id], mode, cfg);
+
+    spare.rsrcId = id;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::swapSlot */
+void AmgXSolver::swapSlot()
+{
+    std::swap(AmgXA, spare.A);
+    std::swap(AmgXP, spare.P);
+    std::swap(AmgXRHS, spare.RHS);
+    std::swap(solver, spare.solver);
+    std::swap(activeRsrc, spare.rsrcId);
+    std::swap(lastDevIS, spare.devIS);
+    std::swap(scatterLhs, spare.scatterLhs);
+    std::swap(scatterRhs, spare.scatterRhs);
+    std::swap(redistLhs, spare.redistLhs);
+    std::swap(redistRhs, spare.redistRhs);
+}
+
+
+/* \implements AmgXSolver::finalizeStage */
+PetscErrorCode AmgXSolver::finalizeStage()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    ierr = waitStage(); CHK;
+
+    if (spare.solver != nullptr)
+    {
+        AMGX_solver_destroy(spare.solver);
+        AMGX_matrix_destroy(spare.A);
+        AMGX_vector_destroy(spare.P);
+        AMGX_vector_destroy(spare.RHS);
+    }
+
+    ierr = ISDestroy(&spare.devIS); CHK;
+    ierr = VecScatterDestroy(&spare.scatterLhs); CHK;
+    ierr = VecScatterDestroy(&spare.scatterRhs); CHK;
+    ierr = VecDestroy(&spare.redistLhs); CHK;
+    ierr = VecDestroy(&spare.redistRhs); CHK;
+    ierr = MatDestroy(&spare.mat); CHK;
+
+    spare = Slot();
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::runStage */
+void AmgXSolver::runStage(StageJob job, std::string *log, double *time)
+{
+    double                      tic = MPI_Wtime();
+
+    std::vector<PetscInt64>     offsets;
+
+    std::vector<float>          narrowed;
+
+    const void                  *values = job.data.data();
+
+    AMGX_distribution_handle    dist;
+
+    // a helper thread starts without a current device
+    if (! job.onHost) cudaSetDevice(job.devID);
+
+    // AmgX reads the values as float in modes with a float matrix
+    if (job.floatMat)
+    {
+        narrowed.assign(job.data.begin(), job.data.end());
+        values = narrowed.data();
+    }
+
+    AMGX_distribution_create(&dist, job.cfg);
+    if (job.usesOffsets)
+    {
+        offsets.assign(job.partData.begin(), job.partData.end());
+        AMGX_distribution_set_partition_data(
+                dist, AMGX_DIST_PARTITION_OFFSETS, offsets.data());
+    }
+    else
+    {
+        AMGX_distribution_set_partition_data(
+                dist, AMGX_DIST_PARTITION_VECTOR, job.partData.data());
+    }
+
+    AMGX_matrix_upload_distributed(
+            job.A, job.nGlobalRows, job.nLocalRows, job.row[job.nLocalRows],
+            1, 1, job.row.data(), job.col.data(), values,
+            nullptr, dist);
+    AMGX_distribution_destroy(dist);
+
+    // grid statistics printed during the setup go to the staged slot
+    printCapture = log;
+    AMGX_solver_setup(job.solver, job.A);
+    printCapture = nullptr;
+
+    AMGX_vector_bind(job.P, job.A);
+    AMGX_vector_bind(job.RHS, job.A);
+
+    *time += MPI_Wtime() - tic;
+}
@@ -0,0 +1,192 @@
+/**
+ * \file stats.cpp
+ * \brief Definition of member functions regarding job-wide statistics.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <algorithm>
+# include <cmath>
+# include <cstdio>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+// bins per decade of the time histograms
+static const int binsPerDecade = 16;
+
+// the lower bound of the time histograms is 10^minExponent seconds
+static const int minExponent = -6;
+
+
+/* \implements AmgXSolver::statBin */
+int AmgXSolver::statBin(const Stat s, const double value)
+{
+    double      b;
+
+    if (s == StIters)
+        b = std::floor(value);
+    else
+        b = (value > 0.0) ?
+            std::floor(binsPerDecade * (std::log10(value) - minExponent)) : 0.0;
+
+    return static_cast<int>(
+            std::max(0.0, std::min(double(Histogram::nBins - 1), b)));
+}
+
+
+/* \implements AmgXSolver::binValue */
+double AmgXSolver::binValue(const Stat s, const int b)
+{
+    if (s == StIters) return b;
+
+    return std::pow(10.0, (b + 0.5) / binsPerDecade + minExponent);
+}
+
+
+/* \implements AmgXSolver::addSample */
+void AmgXSolver::addSample(const Stat s, const double value)
+{
+    Histogram   &h = stats[s];
+
+    h.count += 1;
+    h.sum += value;
+    h.min = std::min(h.min, value);
+    h.max = std::max(h.max, value);
+    h.bins[statBin(s, value)] += 1;
+}
+
+
+/* \implements AmgXSolver::recordSolve */
+PetscErrorCode AmgXSolver::recordSolve(
+        const double time, const PetscInt iters)
+{
+    PetscFunctionBeginUser;
+
+    addSample(StSolve, time);
+
+    // the rank 0 of globalCpuWorld is always in gpuWorld
+    if (myGlobalRank == 0) addSample(StIters, iters);
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::writeStats */
+PetscErrorCode AmgXSolver::writeStats()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    char                file[PETSC_MAX_PATH_LEN];
+    PetscBool           set;
+
+    const int           nBins = Histogram::nBins;
+
+    long long           counts[nStats * (nBins + 1)];
+    double              sums[nStats],
+                        mins[nStats],
+                        maxs[nStats];
+
+    FILE                *fp = nullptr;
+    int                 opened = 1;
+
+    ierr = PetscOptionsGetString(nullptr, nullptr,
+            "-amgx_stats", file, sizeof(file), &set); CHK;
+
+    if (set)
+    {
+        // pack everything so that each quantity needs one reduction
+        for (int s = 0; s < nStats; ++s)
+        {
+            counts[s * (nBins + 1)] = stats[s].count;
+            std::copy(stats[s].bins, stats[s].bins + nBins,
+                    counts + s * (nBins + 1) + 1);
+            sums[s] = stats[s].sum;
+            mins[s] = stats[s].min;
+            maxs[s] = stats[s].max;
+        }
+
+        ierr = MPI_Reduce((myGlobalRank == 0) ? MPI_IN_PLACE : counts, counts,
+                nStats * (nBins + 1), MPI_LONG_LONG, MPI_SUM,
+                0, globalCpuWorld); CHK;
+        ierr = MPI_Reduce((myGlobalRank == 0) ? MPI_IN_PLACE : sums, sums,
+                nStats, MPI_DOUBLE, MPI_SUM, 0, globalCpuWorld); CHK;
+        ierr = MPI_Reduce((myGlobalRank == 0) ? MPI_IN_PLACE : mins, mins,
+                nStats, MPI_DOUBLE, MPI_MIN, 0, globalCpuWorld); CHK;
+        ierr = MPI_Reduce((myGlobalRank == 0) ? MPI_IN_PLACE : maxs, maxs,
+                nStats, MPI_DOUBLE, MPI_MAX, 0, globalCpuWorld); CHK;
+
+        if (myGlobalRank == 0)
+        {
+            fp = std::fopen(serialFileName(file).c_str(), "w");
+            opened = (fp != nullptr);
+        }
+        ierr = MPI_Bcast(&opened, 1, MPI_INT, 0, globalCpuWorld); CHK;
+
+        if (! opened) SETERRQ1(globalCpuWorld, PETSC_ERR_FILE_OPEN,
+                "Can not open statistics file %s.\n",
+                serialFileName(file).c_str());
+    }
+
+    if (fp != nullptr)
+    {
+        std::fprintf(fp, "{\n    \"instance\": %d,\n    \"ranks\": %d", serial,
+                globalSize);
+
+        for (int s = 0; s < nStats; ++s)
+        {
+            long long   n = counts[s * (nBins + 1)];
+            long long   *bins = counts + s * (nBins + 1) + 1;
+
+            std::fprintf(fp, ",\n    \"%s\": {\"unit\": \"%s\", "
+                    "\"count\": %lld", statNames[s],
+                    (s == StIters) ? "iterations" : "s", n);
+
+            if (n == 0)
+            {
+                std::fprintf(fp, ", \"min\": null, \"mean\": null, "
+                        "\"p50\": null, \"p95\": null, \"max\": null}");
+                continue;
+            }
+
+            // percentiles are the representative values of the bins holding
+            // the corresponding samples, clipped to the exact extremes
+            double      pct[2] = {0.50, 0.95};
+            double      val[2];
+
+            for (int k = 0; k < 2; ++k)
+            {
+                long long   target = std::ceil(pct[k] * n),
+                            cumsum = 0;
+                int         b = 0;
+
+                for (; b < nBins - 1; ++b)
+                {
+                    cumsum += bins[b];
+                    if (cumsum >= target) break;
+                }
+
+                val[k] = std::max(mins[s], std::min(maxs[s],
+                            binValue(static_cast<Stat>(s), b)));
+            }
+
+            std::fprintf(fp, ", \"min\": %.9g, \"mean\": %.9g, "
+                    "\"p50\": %.9g, \"p95\": %.9g, \"max\": %.9g}",
+                    mins[s], sums[s] / n, val[0], val[1], maxs[s]);
+        }
+
+        std::fprintf(fp, "\n}\n");
+        std::fclose(fp);
+    }
+
+    // start over in case this instance is initialized again
+    for (int s = 0; s < nStats; ++s) stats[s] = Histogram();
+
+    PetscFunctionReturn(0);
+}
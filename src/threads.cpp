@@ -0,0 +1,96 @@
+/**
+ * \file threads.cpp
+ * \brief Definition of member functions regarding solves from several threads.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// CUDA
+# include <cuda_runtime.h>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::initThreads */
+PetscErrorCode AmgXSolver::initThreads()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscBool           safe = PETSC_FALSE;
+
+    int                 provided;
+
+    ierr = PetscOptionsGetBool(nullptr, nullptr,
+            "-amgx_thread_safe", &safe, nullptr); CHK;
+
+    // instances solving at the same time talk MPI at the same time
+    ierr = MPI_Query_thread(&provided); CHK;
+
+    if (safe && provided != MPI_THREAD_MULTIPLE)
+        SETERRQ(globalCpuWorld, PETSC_ERR_SUP_SYS,
+                "-amgx_thread_safe needs MPI_THREAD_MULTIPLE.\n");
+
+    threadSafe = safe;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::bindDevice */
+PetscErrorCode AmgXSolver::bindDevice()
+{
+    PetscFunctionBeginUser;
+
+    // the current device is a property of the calling thread
+    if (! onHost && (gpuProc == 0 || stream != nullptr))
+    {
+        CHECK(cudaSetDevice(devID));
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::useStream */
+PetscErrorCode AmgXSolver::useStream()
+{
+    PetscFunctionBeginUser;
+
+    if (onHost || stream != nullptr) PetscFunctionReturn(0);
+
+    // copies of this instance must not wait for those of other instances
+    CHECK(cudaSetDevice(devID));
+    CHECK(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::finalizeThreads */
+PetscErrorCode AmgXSolver::finalizeThreads()
+{
+    PetscFunctionBeginUser;
+
+    if (stream != nullptr)
+    {
+        CHECK(cudaStreamSynchronize(stream));
+        CHECK(cudaStreamDestroy(stream));
+        stream = nullptr;
+    }
+
+    threadSafe = false;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::onLogThread */
+bool AmgXSolver::onLogThread()
+{
+    return std::this_thread::get_id() == logThread;
+}
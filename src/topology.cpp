@@ -0,0 +1,122 @@
+/**
+ * \file topology.cpp
+ * \brief Definition of member functions regarding cached topologies.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+/* \implements AmgXSolver::getTopology */
+PetscErrorCode AmgXSolver::getTopology(const MPI_Comm &comm)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    int                 &key = topologyKeys[onHost ? 1 : 0];
+
+    int                 found = 0;
+
+    Topology            *t = nullptr;
+
+    if (key == MPI_KEYVAL_INVALID)
+    {
+        ierr = MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,
+                deleteTopology, nullptr, &key); CHK;
+    }
+
+    ierr = MPI_Comm_get_attr(comm, key, &t, &found); CHK;
+
+    if (! found)
+    {
+        ierr = splitComms(comm); CHK;
+
+        // the cache owns these communicators from now on
+        t = new Topology{globalCpuWorld, localCpuWorld, gpuWorld, devWorld,
+            globalSize, localSize, gpuWorldSize, devWorldSize,
+            myGlobalRank, myLocalRank, myGpuWorldRank, myDevWorldRank,
+            nDevs, devID, gpuProc, 1};
+
+        ierr = MPI_Comm_set_attr(comm, key, t); CHK;
+    }
+
+    t->users += 1;
+    topology = t;
+
+    globalSize = t->globalSize;
+    localSize = t->localSize;
+    gpuWorldSize = t->gpuWorldSize;
+    devWorldSize = t->devWorldSize;
+    myGlobalRank = t->myGlobalRank;
+    myLocalRank = t->myLocalRank;
+    myGpuWorldRank = t->myGpuWorldRank;
+    myDevWorldRank = t->myDevWorldRank;
+    nDevs = t->nDevs;
+    devID = t->devID;
+    gpuProc = t->gpuProc;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::releaseTopology */
+PetscErrorCode AmgXSolver::releaseTopology()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    if (topology == nullptr) PetscFunctionReturn(0);
+
+    ierr = dropTopology(topology); CHK;
+    topology = nullptr;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::dropTopology */
+int AmgXSolver::dropTopology(Topology *t)
+{
+    int                 ierr = MPI_SUCCESS,
+                        err;
+
+    t->users -= 1;
+
+    if (t->users > 0) return MPI_SUCCESS;
+
+    // MPI may call this from MPI_Finalize, after PetscFinalize, so only MPI
+    // error codes; the first error is returned, but all are freed
+    if (t->gpuWorld != MPI_COMM_NULL)
+    {
+        err = MPI_Comm_free(&t->gpuWorld);
+        if (ierr == MPI_SUCCESS) ierr = err;
+    }
+
+    err = MPI_Comm_free(&t->devWorld);
+    if (ierr == MPI_SUCCESS) ierr = err;
+
+    err = MPI_Comm_free(&t->localCpuWorld);
+    if (ierr == MPI_SUCCESS) ierr = err;
+
+    err = MPI_Comm_free(&t->globalCpuWorld);
+    if (ierr == MPI_SUCCESS) ierr = err;
+
+    delete t;
+
+    return ierr;
+}
+
+
+/* \implements AmgXSolver::deleteTopology */
+int AmgXSolver::deleteTopology(MPI_Comm /* comm */, int /* key */,
+        void *value, void * /* extra */)
+{
+    // instances still using it keep it alive
+    return dropTopology(static_cast<Topology*>(value));
+}
@@ -0,0 +1,157 @@
+/**
+ * \file trace.cpp
+ * \brief Definition of member functions regarding the timeline trace.
+ * \date 2026-10-18
+ * \copyright Copyright (c) 2015-2019 Pi-Yueh Chuang, Lorena A. Barba.
+ *            This project is released under MIT License.
+ */
+
+
+// STD
+# include <algorithm>
+# include <cstdio>
+# include <cstring>
+
+// AmgXWrapper
+# include "AmgXSolver.hpp"
+
+
+// what each rank sends to the writing rank before its records
+struct TraceHeader
+{
+    long long   n;
+    double      wait;
+    char        node[MPI_MAX_PROCESSOR_NAME];
+};
+
+
+/* \implements AmgXSolver::initTrace */
+PetscErrorCode AmgXSolver::initTrace()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    char                file[PETSC_MAX_PATH_LEN];
+    PetscBool           set;
+    PetscInt            size = 16384;
+
+    ierr = PetscOptionsGetString(nullptr, nullptr,
+            "-amgx_trace", file, sizeof(file), &set); CHK;
+
+    if (! set) PetscFunctionReturn(0);
+
+    ierr = PetscOptionsGetInt(nullptr, nullptr,
+            "-amgx_trace_size", &size, nullptr); CHK;
+
+    if (size <= 0) SETERRQ1(globalCpuWorld, PETSC_ERR_ARG_OUTOFRANGE,
+            "-amgx_trace_size must be positive, got %D.\n", size);
+
+    // later instances append their serial number so files are not clobbered
+    traceFile = serialFileName(file);
+
+    traceBuffer.resize(size);
+    traceNext = 0;
+    traceWait = 0.0;
+
+    // all ranks leave the barrier at about the same moment, which gives a
+    // common time origin without assuming MPI_WTIME_IS_GLOBAL
+    ierr = MPI_Barrier(globalCpuWorld); CHK;
+    traceOrigin = MPI_Wtime();
+
+    traceEnabled = PETSC_TRUE;
+
+    PetscFunctionReturn(0);
+}
+
+
+/* \implements AmgXSolver::writeTrace */
+PetscErrorCode AmgXSolver::writeTrace()
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    TraceHeader                 header;
+    std::vector<TraceRecord>    records;
+
+    FILE                        *fp = nullptr;
+    int                         opened = 1;
+
+    if (! traceEnabled) PetscFunctionReturn(0);
+
+    // stop recording the MPI communication below
+    traceEnabled = PETSC_FALSE;
+
+    // unroll the ring buffer so that records are sorted by time
+    size_t      cap = traceBuffer.size(),
+                n = std::min(traceNext, cap),
+                first = (traceNext > cap) ? (traceNext % cap) : 0;
+
+    records.resize(n);
+    for (size_t i = 0; i < n; ++i) records[i] = traceBuffer[(first + i) % cap];
+
+    header.n = n;
+    header.wait = traceWait;
+    std::strncpy(header.node, nodeName.c_str(), MPI_MAX_PROCESSOR_NAME - 1);
+    header.node[MPI_MAX_PROCESSOR_NAME - 1] = '\0';
+
+    // every rank has to know whether rank 0 is able to write, or the sends
+    // below would never be matched
+    if (myGlobalRank == 0)
+    {
+        fp = std::fopen(traceFile.c_str(), "w");
+        opened = (fp != nullptr);
+    }
+    ierr = MPI_Bcast(&opened, 1, MPI_INT, 0, globalCpuWorld); CHK;
+
+    if (! opened) SETERRQ1(globalCpuWorld, PETSC_ERR_FILE_OPEN,
+            "Can not open trace file %s.\n", traceFile.c_str());
+
+    if (myGlobalRank != 0)
+    {
+        ierr = MPI_Send(&header, sizeof(TraceHeader), MPI_BYTE,
+                0, 0, globalCpuWorld); CHK;
+        ierr = MPI_Send(records.data(), n * sizeof(TraceRecord), MPI_BYTE,
+                0, 1, globalCpuWorld); CHK;
+    }
+    else
+    {
+        std::fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+
+        for (int r = 0; r < globalSize; ++r)
+        {
+            if (r != 0)
+            {
+                ierr = MPI_Recv(&header, sizeof(TraceHeader), MPI_BYTE,
+                        r, 0, globalCpuWorld, MPI_STATUS_IGNORE); CHK;
+                records.resize(header.n);
+                ierr = MPI_Recv(records.data(), header.n * sizeof(TraceRecord),
+                        MPI_BYTE, r, 1, globalCpuWorld, MPI_STATUS_IGNORE); CHK;
+            }
+
+            // one process per rank; the label shows the total MPI wait
+            std::fprintf(fp, "%s{\"name\": \"process_name\", \"ph\": \"M\", "
+                    "\"pid\": %d, \"args\": {\"name\": \"rank %d\"}},\n",
+                    (r == 0) ? "" : ",\n", r, r);
+            std::fprintf(fp, "{\"name\": \"process_labels\", \"ph\": \"M\", "
+                    "\"pid\": %d, \"args\": {\"labels\": "
+                    "\"%s, MPI wait %.6f s\"}}", r, header.node, header.wait);
+
+            for (const TraceRecord &rec: records)
+                std::fprintf(fp, ",\n{\"name\": \"%s\", \"cat\": \"AmgXSolver\", "
+                        "\"ph\": \"X\", \"pid\": %d, \"tid\": 0, "
+                        "\"ts\": %.3f, \"dur\": %.3f}",
+                        eventNames[rec.event], r, rec.begin * 1e6,
+                        (rec.end - rec.begin) * 1e6);
+        }
+
+        std::fprintf(fp, "\n]}\n");
+        std::fclose(fp);
+    }
+
+    traceBuffer.clear();
+    traceBuffer.shrink_to_fit();
+
+    PetscFunctionReturn(0);
+}
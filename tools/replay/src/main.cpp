@@ -0,0 +1,399 @@
+/**
+ * \file main.cpp
+ * \brief Replay the calls recorded with `-amgx_record` against AmgXSolver.
+ *
+ * Every process reads the record file of its rank and makes the same calls to
+ * `setA`, `updateA`, and `solve`, with the same data and in the same memory
+ * space (host or device), back to back. For each call, the recorded and the
+ * replayed wall times, both the maximum over the processes, are written as one
+ * JSON record per line. This makes production call streams usable as
+ * benchmarks of the wrapper.
+ *
+ * \date 2026-10-18
+ */
+
+
+// STL
+# include <algorithm>
+# include <cstring>
+# include <string>
+# include <vector>
+
+// CUDA
+# include <cuda_runtime.h>
+
+// PETSc
+# include <petscsys.h>
+# include <petscmat.h>
+# include <petscvec.h>
+
+// AmgXWrapper
+# include <AmgXSolver.hpp>
+
+// headers
+# include "reader.hpp"
+
+
+/** \brief A growing buffer in device memory. */
+struct DeviceBuffer
+{
+    void        *ptr = nullptr;
+    size_t      bytes = 0;
+};
+
+
+/**
+ * \brief Copy host data to a device buffer, growing it if necessary.
+ *
+ * \param src [in] the host data.
+ * \param bytes [in] its size.
+ * \param buf [in, out] the buffer.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode upload(const void *src, const size_t bytes, DeviceBuffer &buf)
+{
+    PetscFunctionBeginUser;
+
+    if (bytes > buf.bytes)
+    {
+        CHECK(cudaFree(buf.ptr));
+        CHECK(cudaMalloc(&buf.ptr, bytes));
+        buf.bytes = bytes;
+    }
+
+    CHECK(cudaMemcpy(buf.ptr, src, bytes, cudaMemcpyHostToDevice));
+
+    PetscFunctionReturn(0);
+}
+
+
+/**
+ * \brief Replay all calls of a record file once.
+ *
+ * \param fp [in] the record file, positioned at the first call.
+ * \param mode [in] AmgX mode.
+ * \param config [in] AmgX configuration file.
+ * \param pass [in] index of this pass, for the output.
+ * \param out [in] the file to write the records to.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode replay(FILE *fp, const std::string &mode,
+        const std::string &config, const PetscInt pass, FILE *out)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    AmgXSolver          solver;
+
+    Call                call;
+
+    Mat                 A = nullptr;
+
+    DeviceBuffer        dRow, dCol, dVal, dLhs, dRhs;
+
+    double              total[2] = {0.0, 0.0};
+
+    ierr = solver.initialize(PETSC_COMM_WORLD, mode, config); CHKERRQ(ierr);
+
+    for (PetscInt i = 0; ; ++i)
+    {
+        PetscBool       done;
+
+        int             mine[2],
+                        lo[2],
+                        hi[2];
+
+        double          times[2];
+
+        Vec             lhs = nullptr,
+                        rhs = nullptr;
+
+        std::vector<float>  valuesF,
+                            lhsF,
+                            rhsF;
+
+        ierr = readCall(fp, call, done); CHKERRQ(ierr);
+
+        // all ranks must have recorded the same sequence of calls
+        mine[0] = done;
+        mine[1] = done ? -1 : call.entry.kind;
+        ierr = MPI_Allreduce(mine, lo, 2, MPI_INT, MPI_MIN, PETSC_COMM_WORLD);
+        CHKERRQ(ierr);
+        ierr = MPI_Allreduce(mine, hi, 2, MPI_INT, MPI_MAX, PETSC_COMM_WORLD);
+        CHKERRQ(ierr);
+
+        if (lo[0] != hi[0] || lo[1] != hi[1])
+            SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_FILE_UNEXPECTED,
+                    "The record files disagree at call %D.\n", i);
+
+        if (done) break;
+
+        // what the application prepared before the call is prepared outside
+        // of the timed region
+        const bool  onDevice = call.entry.onDevice;
+        const int   kind = call.entry.kind;
+
+        if (kind == AmgXRecord::SetAMat)
+        {
+            ierr = MatDestroy(&A); CHKERRQ(ierr);
+            ierr = MatCreateMPIAIJWithArrays(PETSC_COMM_WORLD,
+                    call.nLocalRows, call.nLocalRows,
+                    call.nGlobalRows, call.nGlobalRows,
+                    call.row.data(), call.col.data(), call.values.data(), &A);
+            CHKERRQ(ierr);
+        }
+
+        if (kind == AmgXRecord::UpdateAMat)
+        {
+            PetscInt        bg;
+
+            ierr = MatGetOwnershipRange(A, &bg, nullptr); CHKERRQ(ierr);
+
+            for (PetscInt r = 0; r < call.nLocalRows; ++r)
+            {
+                PetscInt    gr = bg + r,
+                            n = call.row[r + 1] - call.row[r];
+
+                ierr = MatSetValues(A, 1, &gr, n, &call.col[call.row[r]],
+                        &call.values[call.row[r]], INSERT_VALUES);
+                CHKERRQ(ierr);
+            }
+
+            ierr = MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+            ierr = MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+        }
+
+        if (kind == AmgXRecord::SolveVec)
+        {
+            PetscScalar     *array;
+
+            ierr = VecCreateMPI(PETSC_COMM_WORLD,
+                    call.lhs.size(), PETSC_DETERMINE, &lhs); CHKERRQ(ierr);
+            ierr = VecDuplicate(lhs, &rhs); CHKERRQ(ierr);
+
+            ierr = VecGetArray(lhs, &array); CHKERRQ(ierr);
+            std::copy(call.lhs.begin(), call.lhs.end(), array);
+            ierr = VecRestoreArray(lhs, &array); CHKERRQ(ierr);
+
+            ierr = VecGetArray(rhs, &array); CHKERRQ(ierr);
+            std::copy(call.rhs.begin(), call.rhs.end(), array);
+            ierr = VecRestoreArray(rhs, &array); CHKERRQ(ierr);
+        }
+
+        if (onDevice && kind == AmgXRecord::SetARaw)
+        {
+            ierr = upload(call.row.data(),
+                    sizeof(PetscInt) * call.row.size(), dRow); CHKERRQ(ierr);
+            ierr = upload(call.col.data(),
+                    sizeof(PetscInt) * call.col.size(), dCol); CHKERRQ(ierr);
+        }
+
+        if (onDevice && (kind == AmgXRecord::SetARaw ||
+                    kind == AmgXRecord::UpdateA))
+        {
+            ierr = upload(call.values.data(),
+                    sizeof(PetscScalar) * call.values.size(), dVal);
+            CHKERRQ(ierr);
+        }
+
+        if (onDevice && kind == AmgXRecord::SolveRaw)
+        {
+            ierr = upload(call.lhs.data(),
+                    sizeof(PetscScalar) * call.lhs.size(), dLhs); CHKERRQ(ierr);
+            ierr = upload(call.rhs.data(),
+                    sizeof(PetscScalar) * call.rhs.size(), dRhs); CHKERRQ(ierr);
+        }
+
+        // the recorded values were widened exactly from these floats
+        if (kind == AmgXRecord::UpdateAFloat)
+        {
+            valuesF.assign(call.values.begin(), call.values.end());
+
+            if (onDevice)
+            {
+                ierr = upload(valuesF.data(),
+                        sizeof(float) * valuesF.size(), dVal); CHKERRQ(ierr);
+            }
+        }
+
+        if (kind == AmgXRecord::SolveRawFloat)
+        {
+            lhsF.assign(call.lhs.begin(), call.lhs.end());
+            rhsF.assign(call.rhs.begin(), call.rhs.end());
+
+            if (onDevice)
+            {
+                ierr = upload(lhsF.data(),
+                        sizeof(float) * lhsF.size(), dLhs); CHKERRQ(ierr);
+                ierr = upload(rhsF.data(),
+                        sizeof(float) * rhsF.size(), dRhs); CHKERRQ(ierr);
+            }
+        }
+
+        ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+        times[1] = MPI_Wtime();
+
+        switch (kind)
+        {
+            case AmgXRecord::SetAMat:
+                ierr = solver.setA(A); CHKERRQ(ierr);
+                break;
+
+            case AmgXRecord::SetARaw:
+                ierr = solver.setA(call.nGlobalRows,
+                        call.nLocalRows, call.nLocalNz,
+                        onDevice ? (PetscInt*) dRow.ptr : call.row.data(),
+                        onDevice ? (PetscInt*) dCol.ptr : call.col.data(),
+                        onDevice ? (PetscScalar*) dVal.ptr :
+                            call.values.data(),
+                        call.part.empty() ? nullptr : call.part.data());
+                CHKERRQ(ierr);
+                break;
+
+            case AmgXRecord::UpdateA:
+                ierr = solver.updateA(call.nLocalRows, call.nLocalNz,
+                        onDevice ? (PetscScalar*) dVal.ptr :
+                            call.values.data()); CHKERRQ(ierr);
+                break;
+
+            case AmgXRecord::UpdateAMat:
+                ierr = solver.updateA(A); CHKERRQ(ierr);
+                break;
+
+            case AmgXRecord::SolveVec:
+                ierr = solver.solve(lhs, rhs); CHKERRQ(ierr);
+                break;
+
+            case AmgXRecord::SolveRaw:
+                ierr = solver.solve(
+                        onDevice ? (PetscScalar*) dLhs.ptr : call.lhs.data(),
+                        onDevice ? (PetscScalar*) dRhs.ptr : call.rhs.data(),
+                        call.lhs.size()); CHKERRQ(ierr);
+                break;
+
+            case AmgXRecord::UpdateAFloat:
+                ierr = solver.updateA(call.nLocalRows, call.nLocalNz,
+                        onDevice ? (float*) dVal.ptr : valuesF.data());
+                CHKERRQ(ierr);
+                break;
+
+            case AmgXRecord::SolveRawFloat:
+                ierr = solver.solve(
+                        onDevice ? (float*) dLhs.ptr : lhsF.data(),
+                        onDevice ? (float*) dRhs.ptr : rhsF.data(),
+                        lhsF.size()); CHKERRQ(ierr);
+                break;
+        }
+
+        times[1] = MPI_Wtime() - times[1];
+        times[0] = call.entry.end - call.entry.begin;
+
+        ierr = MPI_Allreduce(MPI_IN_PLACE, times, 2, MPI_DOUBLE, MPI_MAX,
+                PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+        total[0] += times[0];
+        total[1] += times[1];
+
+        ierr = PetscFPrintf(PETSC_COMM_WORLD, out,
+                "{\"pass\": %D, \"call\": %D, \"kind\": \"%s\", "
+                "\"recorded\": %.6e, \"replayed\": %.6e}\n",
+                pass, i, kindName(kind), times[0], times[1]); CHKERRQ(ierr);
+
+        ierr = VecDestroy(&lhs); CHKERRQ(ierr);
+        ierr = VecDestroy(&rhs); CHKERRQ(ierr);
+    }
+
+    ierr = PetscFPrintf(PETSC_COMM_WORLD, PETSC_STDERR,
+            "Pass %D: recorded %.6e s, replayed %.6e s\n",
+            pass, total[0], total[1]); CHKERRQ(ierr);
+
+    ierr = solver.finalize(); CHKERRQ(ierr);
+    ierr = MatDestroy(&A); CHKERRQ(ierr);
+
+    for (DeviceBuffer *buf: {&dRow, &dCol, &dVal, &dLhs, &dRhs})
+        CHECK(cudaFree(buf->ptr));
+
+    PetscFunctionReturn(0);
+}
+
+
+int main(int argc, char **argv)
+{
+    PetscErrorCode      ierr;
+
+    char                buffer[PETSC_MAX_PATH_LEN];
+
+    PetscBool           set,
+                        toFile;
+
+    std::string         file,
+                        mode,
+                        config,
+                        output;
+
+    PetscInt            repeat = 1;
+
+    AmgXRecord::Header  header;
+
+    FILE                *fp,
+                        *out = PETSC_STDOUT;
+
+
+    ierr = PetscInitialize(&argc, &argv, nullptr, nullptr); CHKERRQ(ierr);
+
+    ierr = PetscOptionsGetString(nullptr, nullptr, "-record",
+            buffer, sizeof(buffer), &set); CHKERRQ(ierr);
+    if (! set) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_NULL,
+            "-record is required.\n");
+    file = buffer;
+
+    ierr = openRecord(file, header, fp); CHKERRQ(ierr);
+    mode = header.mode;
+    config = header.config;
+
+    // the recorded configuration may not exist on this machine
+    ierr = PetscOptionsGetString(nullptr, nullptr, "-config",
+            buffer, sizeof(buffer), &set); CHKERRQ(ierr);
+    if (set) config = buffer;
+
+    // configurations given as strings or options are not recorded
+    if (config.empty()) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_NULL,
+            "The record has no configuration file; -config is required.\n");
+
+    ierr = PetscOptionsGetString(nullptr, nullptr, "-mode",
+            buffer, sizeof(buffer), &set); CHKERRQ(ierr);
+    if (set) mode = buffer;
+
+    ierr = PetscOptionsGetString(nullptr, nullptr, "-output",
+            buffer, sizeof(buffer), &toFile); CHKERRQ(ierr);
+    if (toFile)
+    {
+        ierr = PetscFOpen(PETSC_COMM_WORLD, buffer, "w", &out); CHKERRQ(ierr);
+    }
+
+    ierr = PetscOptionsGetInt(nullptr, nullptr, "-repeat", &repeat, nullptr);
+    CHKERRQ(ierr);
+
+    for (PetscInt pass = 0; pass < repeat; ++pass)
+    {
+        if (std::fseek(fp, sizeof(header), SEEK_SET) != 0)
+            SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_READ,
+                    "Can not rewind the record file.\n");
+
+        ierr = replay(fp, mode, config, pass, out); CHKERRQ(ierr);
+    }
+
+    std::fclose(fp);
+
+    if (toFile)
+    {
+        ierr = PetscFClose(PETSC_COMM_WORLD, out); CHKERRQ(ierr);
+    }
+
+    ierr = PetscFinalize(); CHKERRQ(ierr);
+
+    return 0;
+}
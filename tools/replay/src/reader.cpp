@@ -0,0 +1,199 @@
+/**
+ * \file reader.cpp
+ * \brief Definitions of functions reading files written by `-amgx_record`.
+ * \date 2026-10-18
+ */
+
+
+// STL
+# include <cstring>
+
+// headers
+# include "reader.hpp"
+
+
+namespace
+{
+
+/** \brief Read exactly \p n items, or fail. */
+template <typename T>
+PetscErrorCode readArray(FILE *fp, T *data, const PetscInt n)
+{
+    PetscFunctionBeginUser;
+
+    if (n > 0 && std::fread(data, sizeof(T), n, fp) != (size_t) n)
+        SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED,
+                "The record file is truncated.\n");
+
+    PetscFunctionReturn(0);
+}
+
+} // end of anonymous namespace
+
+
+// definition of openRecord
+PetscErrorCode openRecord(const std::string &file,
+        AmgXRecord::Header &header, FILE *&fp)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscMPIInt         rank,
+                        size;
+
+    ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+    ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
+
+    std::string     name = file + "." + std::to_string(rank);
+
+    fp = std::fopen(name.c_str(), "rb");
+
+    if (fp == nullptr) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN,
+            "Can not open %s.\n", name.c_str());
+
+    ierr = readArray(fp, &header, 1); CHKERRQ(ierr);
+
+    if (std::memcmp(header.magic, AmgXRecord::magic, sizeof(header.magic)))
+        SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED,
+                "%s is not a record file.\n", name.c_str());
+
+    // later versions only added kinds of calls
+    if (header.version < 1 || header.version > AmgXRecord::version)
+        SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED,
+                "%s has version %d; only versions 1 to %d are supported.\n",
+                name.c_str(), header.version, AmgXRecord::version);
+
+    if (header.size != size || header.rank != rank)
+        SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ,
+                "%s was recorded with %d processes, but %d are running.\n",
+                name.c_str(), header.size, size);
+
+    if (header.intSize != sizeof(PetscInt) ||
+            header.scalarSize != sizeof(PetscScalar))
+        SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG,
+                "%s was recorded with different PetscInt or PetscScalar.\n",
+                name.c_str());
+
+    // guard against files written by a buggy or foreign recorder
+    header.mode[sizeof(header.mode) - 1] = '\0';
+    header.config[sizeof(header.config) - 1] = '\0';
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of readCall
+PetscErrorCode readCall(FILE *fp, Call &call, PetscBool &done)
+{
+    PetscFunctionBeginUser;
+
+    PetscErrorCode      ierr;
+
+    PetscInt            sizes[4];
+
+    done = PETSC_FALSE;
+
+    if (std::fread(&call.entry, sizeof(call.entry), 1, fp) != 1)
+    {
+        if (std::feof(fp)) { done = PETSC_TRUE; PetscFunctionReturn(0); }
+
+        SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_READ,
+                "Can not read the record file.\n");
+    }
+
+    switch (call.entry.kind)
+    {
+        case AmgXRecord::SetAMat:
+        case AmgXRecord::SetARaw:
+            ierr = readArray(fp, sizes, 4); CHKERRQ(ierr);
+
+            call.nGlobalRows = sizes[0];
+            call.nLocalRows = sizes[1];
+            call.nLocalNz = sizes[2];
+
+            call.row.resize(call.nLocalRows + 1);
+            call.col.resize(call.nLocalNz);
+            call.values.resize(call.nLocalNz);
+            call.part.resize(sizes[3] ? call.nGlobalRows : 0);
+
+            ierr = readArray(fp, call.row.data(), call.row.size());
+            CHKERRQ(ierr);
+            ierr = readArray(fp, call.col.data(), call.col.size());
+            CHKERRQ(ierr);
+            ierr = readArray(fp, call.values.data(), call.values.size());
+            CHKERRQ(ierr);
+            ierr = readArray(fp, call.part.data(), call.part.size());
+            CHKERRQ(ierr);
+            break;
+
+        case AmgXRecord::UpdateA:
+        case AmgXRecord::UpdateAMat:
+        case AmgXRecord::UpdateAFloat:
+            ierr = readArray(fp, sizes, 3); CHKERRQ(ierr);
+
+            call.nLocalRows = sizes[0];
+            call.nLocalNz = sizes[1];
+
+            if (sizes[2] < 0)
+            {
+                call.values.resize(call.nLocalNz);
+                ierr = readArray(fp, call.values.data(), call.nLocalNz);
+                CHKERRQ(ierr);
+            }
+            else
+            {
+                std::vector<PetscInt>       pos(sizes[2]);
+                std::vector<PetscScalar>    val(sizes[2]);
+
+                ierr = readArray(fp, pos.data(), sizes[2]); CHKERRQ(ierr);
+                ierr = readArray(fp, val.data(), sizes[2]); CHKERRQ(ierr);
+
+                if ((PetscInt) call.values.size() != call.nLocalNz)
+                    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED,
+                            "A delta of values does not match the matrix.\n");
+
+                for (PetscInt i = 0; i < sizes[2]; ++i)
+                    call.values[pos[i]] = val[i];
+            }
+            break;
+
+        case AmgXRecord::SolveVec:
+        case AmgXRecord::SolveRaw:
+        case AmgXRecord::SolveRawFloat:
+            ierr = readArray(fp, sizes, 1); CHKERRQ(ierr);
+
+            call.lhs.resize(sizes[0]);
+            call.rhs.resize(sizes[0]);
+
+            ierr = readArray(fp, call.lhs.data(), sizes[0]); CHKERRQ(ierr);
+            ierr = readArray(fp, call.rhs.data(), sizes[0]); CHKERRQ(ierr);
+            break;
+
+        default:
+            SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_UNEXPECTED,
+                    "Unknown kind of call %d in the record file.\n",
+                    call.entry.kind);
+    }
+
+    PetscFunctionReturn(0);
+}
+
+
+// definition of kindName
+const char *kindName(const int kind)
+{
+    switch (kind)
+    {
+        case AmgXRecord::SetAMat: return "setA(Mat)";
+        case AmgXRecord::SetARaw: return "setA(CSR)";
+        case AmgXRecord::UpdateA: return "updateA";
+        case AmgXRecord::UpdateAMat: return "updateA(Mat)";
+        case AmgXRecord::SolveVec: return "solve(Vec)";
+        case AmgXRecord::SolveRaw: return "solve(raw)";
+        case AmgXRecord::UpdateAFloat: return "updateA(float)";
+        case AmgXRecord::SolveRawFloat: return "solve(float)";
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,84 @@
+/**
+ * \file reader.hpp
+ * \brief Prototypes of functions reading files written by `-amgx_record`.
+ * \date 2026-10-18
+ */
+
+
+# pragma once
+
+// STL
+# include <cstdio>
+# include <string>
+# include <vector>
+
+// PETSc
+# include <petscsys.h>
+
+// AmgXWrapper
+# include <AmgXRecord.hpp>
+
+
+/** \brief A recorded call and everything needed to make it again. */
+struct Call
+{
+    /** \brief Kind and timestamps of the call. */
+    AmgXRecord::Entry           entry;
+
+    /** \brief Global rows, local rows, local non-zeros. */
+    PetscInt                    nGlobalRows = 0,
+                                nLocalRows = 0,
+                                nLocalNz = 0;
+
+    /** \brief Row offsets and global column indices of the last setA. */
+    std::vector<PetscInt>       row,
+                                col;
+
+    /** \brief Partition vector of the last setA, or empty. */
+    std::vector<PetscInt>       part;
+
+    /** \brief Matrix values as of this call; deltas are applied here. */
+    std::vector<PetscScalar>    values;
+
+    /** \brief Initial guess and right-hand side of a solve. */
+    std::vector<PetscScalar>    lhs,
+                                rhs;
+};
+
+
+/**
+ * \brief Open the record file of this rank and check its header.
+ *
+ * \param file [in] the file name given to `-amgx_record`.
+ * \param header [out] the header of the file.
+ * \param fp [out] the opened file, positioned at the first call.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode openRecord(const std::string &file,
+        AmgXRecord::Header &header, FILE *&fp);
+
+
+/**
+ * \brief Read the next call.
+ *
+ * Fields of \p call that the call does not change keep their values, so the
+ * same object has to be passed for all calls of a file.
+ *
+ * \param fp [in] the record file.
+ * \param call [in, out] the call.
+ * \param done [out] whether the end of the file was reached instead.
+ *
+ * \return PetscErrorCode.
+ */
+PetscErrorCode readCall(FILE *fp, Call &call, PetscBool &done);
+
+
+/**
+ * \brief Name of a kind of call.
+ *
+ * \param kind [in] an AmgXRecord::Kind.
+ *
+ * \return The name.
+ */
+const char *kindName(const int kind);